@@ -1,6 +1,7 @@
 import QtQuick
 import QtQuick.Controls.Basic
 import QtQuick.Layouts
+import GodrollLauncher.Native 1.0
 
 Rectangle {
     id: searchWindow
@@ -19,6 +20,20 @@ Rectangle {
     // Loading state from parent
     property bool isLoading: false
 
+    // Memory diagnostics overlay (F12)
+    property bool showDiagnostics: false
+    property var memoryStats: ({})
+    property var iconStats: ({})
+    property var latencyStats: ({})
+
+    function formatLatency(metric) {
+        return metric && metric.count > 0 ? metric.p50.toFixed(1) + "/" + metric.p99.toFixed(1) + " ms" : "–"
+    }
+
+    function formatKB(bytes) {
+        return Math.round((bytes || 0) / 1024) + " KB"
+    }
+
     // Function to focus search input and select first item (used on initial show)
     function focusSearchInput() {
         searchInput.forceActiveFocus()
@@ -519,11 +534,21 @@ Rectangle {
                     event.accepted = true
                 }
                 
-                // F5 to reload weapon list
+                // F5 to reload weapon list, F12 to toggle diagnostics, F11 to export a latency trace
                 Keys.onPressed: function(event) {
                     if (event.key === Qt.Key_F5) {
+                        searchModel.logMemoryStats()
                         weaponLoader.reload()
                         event.accepted = true
+                    } else if (event.key === Qt.Key_F12) {
+                        searchWindow.memoryStats = searchModel.memoryStats()
+                        searchWindow.iconStats = iconCache.memoryStats()
+                        searchWindow.latencyStats = latencyTracer.stats()
+                        searchWindow.showDiagnostics = !searchWindow.showDiagnostics
+                        event.accepted = true
+                    } else if (event.key === Qt.Key_F11) {
+                        latencyTracer.exportTrace()
+                        event.accepted = true
                     }
                 }
             }
@@ -671,6 +696,18 @@ Rectangle {
                 }
                 // Reset mouse tracking when list changes
                 searchWindow.mouseHasMoved = false
+                prefetchedAfter = -1
+            }
+            
+            // Hint the next page of icons while scrolling, once per newly reached row
+            property int prefetchedAfter: -1
+            onContentYChanged: {
+                var lastVisible = indexAt(0, contentY + height - 1)
+                if (lastVisible >= 0 && lastVisible > prefetchedAfter) {
+                    prefetchedAfter = lastVisible
+                    var pageRows = Math.max(1, Math.ceil(height / 91))  // Row height plus spacing
+                    searchModel.prefetchRows(lastVisible + 1, pageRows)
+                }
             }
             
             // Ensure selected item is visible
@@ -702,26 +739,79 @@ Rectangle {
                 background: Item {}
             }
 
-            delegate: WeaponItem {
-                width: resultsList.width
-                highlighted: resultsList.currentIndex === index
-                fontFamily: searchWindow.mainFont
-                
-                onClicked: {
-                    searchModel.openWeapon(index)
-                    searchWindow.close()
-                }
-                
-                onMiddleClicked: {
-                    // Open weapon and request refocus after browser takes focus
-                    searchModel.openWeapon(index)
-                    searchWindow.refocusNeeded()
+            // Rows are recycled while scrolling and retyping; state is reset on reuse
+            reuseItems: true
+            delegate: useNativeRows ? nativeRowDelegate : weaponItemDelegate
+
+            Component {
+                id: weaponItemDelegate
+
+                WeaponItem {
+                    width: resultsList.width
+                    highlighted: resultsList.currentIndex === index
+                    fontFamily: searchWindow.mainFont
+                    
+                    onClicked: {
+                        searchModel.openWeapon(index)
+                        searchWindow.close()
+                    }
+                    
+                    onMiddleClicked: {
+                        // Open weapon and request refocus after browser takes focus
+                        searchModel.openWeapon(index)
+                        searchWindow.refocusNeeded()
+                    }
+                    
+                    onHoveredChanged: {
+                        // Only respond to hover if mouse has moved since window appeared
+                        if (hovered && searchWindow.mouseHasMoved) {
+                            resultsList.currentIndex = index
+                        }
+                    }
                 }
-                
-                onHoveredChanged: {
-                    // Only respond to hover if mouse has moved since window appeared
-                    if (hovered && searchWindow.mouseHasMoved) {
-                        resultsList.currentIndex = index
+            }
+
+            // Single-node C++ row with the same look and handlers (nativeRows setting)
+            Component {
+                id: nativeRowDelegate
+
+                WeaponRow {
+                    width: resultsList.width
+                    height: 85
+                    name: model.name
+                    matchSpans: model.matchSpans || []
+                    weaponType: model.weaponType || ""
+                    frameType: model.frameType || ""
+                    seasonNumber: model.seasonNumber || 0
+                    seasonName: model.seasonName || ""
+                    matchedField: model.matchedField || ""
+                    isHolofoil: model.isHolofoil === true
+                    icon: model.icon || ""
+                    damageTypeIcon: model.damageTypeIcon || ""
+                    ammoTypeIcon: model.ammoTypeIcon || ""
+                    highlighted: resultsList.currentIndex === index
+                    fontFamily: searchWindow.mainFont
+
+                    ListView.onPooled: hovered = false
+
+                    onMouseMoved: function(windowX, windowY) {
+                        searchWindow.checkMouseMoved(windowX, windowY)
+                    }
+
+                    onClicked: {
+                        searchModel.openWeapon(index)
+                        searchWindow.close()
+                    }
+
+                    onMiddleClicked: {
+                        searchModel.openWeapon(index)
+                        searchWindow.refocusNeeded()
+                    }
+
+                    onHoveredChanged: {
+                        if (hovered && searchWindow.mouseHasMoved) {
+                            resultsList.currentIndex = index
+                        }
                     }
                 }
             }
@@ -796,6 +886,73 @@ Rectangle {
             maximumLineCount: 1
         }
 
+        // Memory diagnostics (F12), snapshot taken when toggled on
+        Text {
+            Layout.fillWidth: true
+            Layout.leftMargin: 20
+            Layout.rightMargin: 20
+            visible: searchWindow.showDiagnostics
+            text: memoryStats.weapons + " weapons • catalog " + formatKB(memoryStats.catalog)
+                  + " • index " + formatKB(memoryStats.index)
+                  + " • cache " + formatKB(memoryStats.resultCache) + " (" + memoryStats.resultCacheEntries + ")"
+                  + " • views " + formatKB(memoryStats.defaultViews)
+                  + " • results " + formatKB(memoryStats.results)
+            font.family: searchWindow.mainFont
+            font.pixelSize: 12
+            color: "#777777"
+            horizontalAlignment: Text.AlignHCenter
+            elide: Text.ElideRight
+        }
+
+        // Icon memory: decoded images (LRU and pinned) and the disk cache
+        Text {
+            Layout.fillWidth: true
+            Layout.leftMargin: 20
+            Layout.rightMargin: 20
+            visible: searchWindow.showDiagnostics
+            text: "icons " + formatKB(iconStats.decoded) + " (" + iconStats.decodedEntries + ")"
+                  + " • pinned " + formatKB(iconStats.pinned) + " (" + iconStats.pinnedEntries + ")"
+                  + " • disk " + formatKB(iconStats.disk) + " (" + iconStats.diskFiles + " files)"
+            font.family: searchWindow.mainFont
+            font.pixelSize: 12
+            color: "#777777"
+            horizontalAlignment: Text.AlignHCenter
+            elide: Text.ElideRight
+        }
+
+        // Latency percentiles (p50/p99), snapshot taken with the memory diagnostics
+        Text {
+            Layout.fillWidth: true
+            Layout.leftMargin: 20
+            Layout.rightMargin: 20
+            visible: searchWindow.showDiagnostics
+            text: "hotkey " + formatLatency(latencyStats.hotkeyToVisible)
+                  + " • keystroke " + formatLatency(latencyStats.keystroke)
+                  + " • frame " + formatLatency(latencyStats.frame)
+                  + " • F11 exports trace.json"
+            font.family: searchWindow.mainFont
+            font.pixelSize: 12
+            color: "#777777"
+            horizontalAlignment: Text.AlignHCenter
+            elide: Text.ElideRight
+        }
+
+        // Offline notice: the loader serves the last good catalog and keeps retrying
+        Text {
+            Layout.fillWidth: true
+            Layout.leftMargin: 20
+            Layout.rightMargin: 20
+            visible: !isLoading && weaponLoader.stale
+            text: weaponLoader.lastUpdated.getTime()
+                  ? "Couldn't reach godroll.tv, showing weapons from " + weaponLoader.lastUpdated.toLocaleString(Qt.locale(), Locale.ShortFormat)
+                  : "Couldn't reach godroll.tv, retrying..."
+            font.family: searchWindow.mainFont
+            font.pixelSize: 13
+            color: "#d7a909"
+            horizontalAlignment: Text.AlignHCenter
+            elide: Text.ElideRight
+        }
+
         // Keyboard shortcut hint
         Text {
             Layout.fillWidth: true
@@ -8,13 +8,22 @@ Rectangle {
     color: highlighted ? "#CC2a2a2a" : (hovered ? "#CC242424" : "#CC1e1e1e")  // Semi-transparent
 
     property bool hovered: false
+    property bool pooled: false  // Parked by the ListView for reuse
     property bool highlighted: false
     property string fontFamily: "Segoe UI"
     
     signal clicked()
     signal middleClicked()  // Middle click to open without closing window
 
+    // Recycled delegates: drop hover and skip transitions while the new row's data is bound
+    ListView.onPooled: {
+        pooled = true
+        hovered = false
+    }
+    ListView.onReused: pooled = false
+
     Behavior on color {
+        enabled: !root.pooled
         ColorAnimation { duration: 100 }
     }
 
@@ -30,6 +39,7 @@ Rectangle {
         opacity: highlighted ? 1.0 : 0.0
         
         Behavior on opacity {
+            enabled: !root.pooled
             NumberAnimation { duration: 100 }
         }
     }
@@ -76,10 +86,11 @@ Rectangle {
             Image {
                 anchors.fill: parent
                 anchors.margins: 8
-                source: model.icon ? "https://www.bungie.net" + model.icon : ""
+                source: model.icon ? "image://icons" + model.icon : ""
+                sourceSize: Qt.size(52, 52)  // Decoded at display size and shared through the icon cache
                 fillMode: Image.PreserveAspectFit
                 smooth: true
-                mipmap: true
+                mipmap: false  // Already display-sized; unmipmapped icons share the scene graph's texture atlas
                 antialiasing: true
                 cache: true
                 asynchronous: true
@@ -97,7 +108,10 @@ Rectangle {
                 Layout.fillWidth: true
                 
                 Text {
-                    text: model.name
+                    // Highlighted markup is built by the model; empty when nothing matched the name
+                    property string highlightedName: model.highlightedName || ""
+                    text: highlightedName.length > 0 ? highlightedName : model.name
+                    textFormat: highlightedName.length > 0 ? Text.StyledText : Text.PlainText
                     font.family: root.fontFamily
                     font.pixelSize: 20
                     font.weight: Font.Bold
@@ -106,6 +120,7 @@ Rectangle {
                     Layout.maximumWidth: implicitWidth
                     
                     Behavior on color {
+                        enabled: !root.pooled
                         ColorAnimation { duration: 100 }
                     }
                 }
@@ -130,7 +145,7 @@ Rectangle {
                         to: 1
                         duration: 5000
                         loops: Animation.Infinite
-                        running: holofoilBadge.visible
+                        running: holofoilBadge.visible && !root.pooled
                     }
                     
                     // Animated rainbow gradient overlay
@@ -164,12 +179,13 @@ Rectangle {
                 // Damage type icon
                 Image {
                     visible: model.damageTypeIcon && model.damageTypeIcon.length > 0
-                    source: model.damageTypeIcon ? "https://www.bungie.net" + model.damageTypeIcon : ""
+                    source: model.damageTypeIcon ? "image://icons" + model.damageTypeIcon : ""
+                    sourceSize: Qt.size(18, 18)
                     Layout.preferredWidth: 18
                     Layout.preferredHeight: 18
                     fillMode: Image.PreserveAspectFit
                     smooth: true
-                    mipmap: true
+                    mipmap: false
                     antialiasing: true
                     cache: true
                     asynchronous: true
@@ -178,12 +194,13 @@ Rectangle {
                 // Ammo type icon
                 Image {
                     visible: model.ammoTypeIcon && model.ammoTypeIcon.length > 0
-                    source: model.ammoTypeIcon ? "https://www.bungie.net" + model.ammoTypeIcon : ""
+                    source: model.ammoTypeIcon ? "image://icons" + model.ammoTypeIcon : ""
+                    sourceSize: Qt.size(18, 18)
                     Layout.preferredWidth: 18
                     Layout.preferredHeight: 18
                     fillMode: Image.PreserveAspectFit
                     smooth: true
-                    mipmap: true
+                    mipmap: false
                     antialiasing: true
                     cache: true
                     asynchronous: true
@@ -56,9 +56,20 @@ Window {
             root.raise()
             root.requestActivate()
         }
-        
-        // Check for updates after a short delay
-        updateCheckTimer.start()
+    }
+    
+    // The update checker is created after startup (see main.cpp); check shortly after it arrives
+    property var deferredUpdateChecker: updateChecker
+    onDeferredUpdateCheckerChanged: {
+        if (!deferredUpdateChecker) {
+            return
+        }
+        if (root.manualUpdateCheck) {
+            // Requested from the tray before it existed
+            updateChecker.checkForUpdates()
+        } else {
+            updateCheckTimer.start()
+        }
     }
     
     // Timer to check for updates after app starts
@@ -79,13 +90,15 @@ Window {
             if ((updateAvailable || root.manualUpdateCheck) && !root.updateDialogShown) {
                 root.updateDialogShown = true
                 // Show window if hidden
+                windowWarmer.finish()
                 if (!root.visible) {
                     root.show()
                     root.raise()
                     root.requestActivate()
                     root.opacity = 1
                 }
-                updateDialog.show()
+                updateDialogLoader.active = true
+                updateDialogLoader.item.show()
             }
         }
         
@@ -93,6 +106,7 @@ Window {
             // Show a notification that we just updated
             console.log("Just updated to version:", version)
             // Show window if hidden
+            windowWarmer.finish()
             if (!root.visible) {
                 root.show()
                 root.raise()
@@ -129,11 +143,27 @@ Window {
             root.isLoading = false
             searchWindowComponent.focusSearchInput()
         }
+        function onWeaponsUnchanged() {
+            root.isLoading = false
+            searchWindowComponent.focusSearchInput()
+        }
+        function onLoadFailed() {
+            // Keep showing the last catalog (if any), the loader keeps retrying in the background
+            root.isLoading = false
+        }
+    }
+
+    // Scheduled catalog refreshes wait until the window is hidden. A pre-warm render is not
+    // the user looking at it: its show and hide must not hold back or release a refresh.
+    onVisibleChanged: {
+        if (!windowWarmer.warming) {
+            weaponLoader.setWindowVisible(visible)
+        }
     }
 
     // Hide when focus is lost (no reset, just hide with animation)
     onActiveChanged: {
-        if (!active && visible && !ignoreFocusLoss && !isHiding) {
+        if (!active && visible && !ignoreFocusLoss && !isHiding && !windowWarmer.warming) {
             isHiding = true
             root.opacity = 0
         }
@@ -153,6 +183,7 @@ Window {
         }
         function onCheckForUpdatesRequested() {
             // Show window first if hidden
+            windowWarmer.finish()
             if (!root.visible) {
                 root.show()
                 root.raise()
@@ -162,11 +193,16 @@ Window {
             // Reset the update dialog shown flag to allow showing again
             root.updateDialogShown = false
             root.manualUpdateCheck = true
-            updateChecker.checkForUpdates()
+            // Before the checker exists, onDeferredUpdateCheckerChanged runs this check
+            if (updateChecker) {
+                updateChecker.checkForUpdates()
+            }
         }
     }
 
     function toggleWindow() {
+        // A pre-warm render in progress counts as hidden
+        windowWarmer.finish()
         if (root.visible && !isHiding) {
             // Just hide with animation, no reset (reset only happens on ESC)
             isHiding = true
@@ -231,7 +267,7 @@ Window {
         id: updateDialogOverlay
         anchors.fill: parent
         color: "transparent"
-        visible: updateDialog.visible
+        visible: updateDialogLoader.item ? updateDialogLoader.item.visible : false
         z: 99
         
         MouseArea {
@@ -245,20 +281,23 @@ Window {
         }
     }
     
-    // Update Dialog - centered overlay
-    UpdateDialog {
-        id: updateDialog
+    // Update Dialog - centered overlay, only compiled once an update check wants to show it
+    Loader {
+        id: updateDialogLoader
         anchors.centerIn: parent
         z: 100
+        active: false
         
-        onAccepted: {
-            console.log("Update download started")
-        }
-        onRejected: {
-            console.log("Update postponed")
-        }
-        onSkipped: {
-            console.log("Update skipped")
+        sourceComponent: UpdateDialog {
+            onAccepted: {
+                console.log("Update download started")
+            }
+            onRejected: {
+                console.log("Update postponed")
+            }
+            onSkipped: {
+                console.log("Update skipped")
+            }
         }
     }
     
@@ -0,0 +1,633 @@
+#include "iconcache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QMutexLocker>
+#include <QBuffer>
+#include <QImageReader>
+#include <QPainter>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QFutureWatcher>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <algorithm>
+
+IconCache::IconCache(QObject *parent)
+    : QObject(parent)
+    , m_dir(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/icons")
+{
+    QSettings settings("Godroll.tv", "GodrollLauncher");
+    m_maxBytes = qint64(qMax(1, settings.value("iconCacheSizeMB", DEFAULT_DISK_BUDGET_MB).toInt())) * 1024 * 1024;
+    m_images.setMaxCost(qMax(1, settings.value("iconMemoryMB", DEFAULT_MEMORY_BUDGET_MB).toInt()) * 1024);
+
+    connect(&m_network, &QNetworkAccessManager::finished, this, &IconCache::onDownloadFinished);
+    
+    // Painters waiting in requestDecoded() for a download
+    connect(this, &IconCache::iconAvailable, this, [this](const QString &path, const QByteArray &data) {
+        const QList<QSize> sizes = m_pendingDecodes.values(path);
+        for (const QSize &size : sizes) {
+            decodeInBackground(path, size, data);
+        }
+    });
+    connect(this, &IconCache::iconFailed, this, [this](const QString &path) {
+        m_pendingDecodes.remove(path);
+    });
+    
+    m_atlasPool.setMaxThreadCount(1);
+    m_atlasPool.setThreadPriority(QThread::IdlePriority);
+    QDir().mkpath(m_dir);
+    m_atlasPool.start([this]() { indexDirectory(); });
+    m_atlasPool.start([this]() { loadAtlas(); });
+}
+
+IconCache::~IconCache()
+{
+    // Both pools run tasks that capture this
+    m_decodePool.clear();
+    m_decodePool.waitForDone();
+    m_atlasPool.waitForDone();
+}
+
+QUrl IconCache::iconUrl(const QString &path)
+{
+    return QUrl("https://www.bungie.net" + (path.startsWith('/') ? path : "/" + path));
+}
+
+QString IconCache::fileKey(const QString &path)
+{
+    return QString::fromLatin1(QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Sha1).toHex());
+}
+
+QString IconCache::imageKey(const QString &path, const QSize &size)
+{
+    return QString("%1@%2x%3").arg(path).arg(size.width()).arg(size.height());
+}
+
+QImage IconCache::decodedImage(const QString &path, const QSize &size)
+{
+    const QString key = imageKey(path, size);
+    QMutexLocker locker(&m_imageMutex);
+    auto pinned = m_pinnedImages.constFind(key);
+    if (pinned != m_pinnedImages.constEnd()) {
+        return *pinned;
+    }
+    const QImage *image = m_images.object(key);
+    return image ? *image : QImage();
+}
+
+void IconCache::insertDecodedImage(const QString &path, const QSize &size, const QImage &image)
+{
+    if (image.isNull()) {
+        return;
+    }
+    const QString key = imageKey(path, size);
+    QMutexLocker locker(&m_imageMutex);
+    if (m_pinnedPaths.contains(path)) {
+        m_pinnedImages.insert(key, image);
+    } else {
+        m_images.insert(key, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+    }
+}
+
+void IconCache::requestDecoded(const QString &path, const QSize &size)
+{
+    if (m_pendingDecodes.contains(path, size)) {
+        return;
+    }
+    m_pendingDecodes.insert(path, size);
+    decodeInBackground(path, size, QByteArray());
+}
+
+// Empty data reads the disk cache first and downloads on a miss
+void IconCache::decodeInBackground(const QString &path, const QSize &size, const QByteArray &data)
+{
+    // 1 = decoded, 0 = not on disk yet, -1 = undecodable (stays pending so painters do not retry)
+    auto *watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this, [this, watcher, path, size]() {
+        watcher->deleteLater();
+        const int result = watcher->result();
+        if (result > 0) {
+            m_pendingDecodes.remove(path, size);
+            emit decodedImageReady(path);
+        } else if (result == 0) {
+            requestIcon(path);
+        }
+    });
+    watcher->setFuture(QtConcurrent::run(&m_decodePool, [this, path, size, data]() {
+        const QByteArray bytes = data.isEmpty() ? readCached(path) : data;
+        if (bytes.isEmpty()) {
+            return 0;
+        }
+        const QImage image = decode(bytes, size);
+        if (image.isNull()) {
+            return -1;
+        }
+        insertDecodedImage(path, size, image);
+        return 1;
+    }));
+}
+
+void IconCache::setPinnedIcons(const QStringList &paths)
+{
+    QMutexLocker locker(&m_imageMutex);
+    m_pinnedPaths = QSet<QString>(paths.cbegin(), paths.cend());
+    
+    // Move already decoded images of newly pinned icons over, drop ones no longer pinned
+    for (auto it = m_pinnedImages.begin(); it != m_pinnedImages.end();) {
+        if (!m_pinnedPaths.contains(it.key().section('@', 0, -2))) {
+            it = m_pinnedImages.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    const QList<QString> keys = m_images.keys();
+    for (const QString &key : keys) {
+        if (m_pinnedPaths.contains(key.section('@', 0, -2))) {
+            m_pinnedImages.insert(key, *m_images.object(key));
+            m_images.remove(key);
+        }
+    }
+}
+
+// Scanned on the atlas pool right after construction, without holding m_mutex, so neither
+// the GUI thread nor image workers wait on the directory listing. Until it finishes lookups
+// go straight to the file system.
+void IconCache::indexDirectory()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    const QFileInfoList files = QDir(m_dir).entryInfoList(QDir::Files);
+    QHash<QString, Entry> scanned;
+    scanned.reserve(files.size());
+    for (const QFileInfo &info : files) {
+        Entry entry;
+        entry.size = info.size();
+        entry.lastUsed = info.lastModified().toMSecsSinceEpoch();
+        scanned.insert(info.fileName(), entry);
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    // Files stored or read during the scan are already indexed with a newer lastUsed
+    for (auto it = scanned.cbegin(); it != scanned.cend(); ++it) {
+        if (!m_index.contains(it.key())) {
+            m_index.insert(it.key(), it.value());
+            m_totalBytes += it->size;
+        }
+    }
+    m_indexed = true;
+    qDebug() << "Icon cache:" << m_index.size() << "files," << m_totalBytes / 1024 << "KB, indexed in" << timer.elapsed() << "ms";
+    evict();
+}
+
+QByteArray IconCache::readCached(const QString &path)
+{
+    const QString key = fileKey(path);
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_index.find(key);
+        if (it != m_index.end()) {
+            it->lastUsed = QDateTime::currentMSecsSinceEpoch();
+        } else if (m_indexed) {
+            return QByteArray();
+        }
+    }
+    
+    // Before the index is ready a missing file is simply a miss; the scan records the rest
+    const QByteArray data = readFile(key);
+    if (data.isEmpty()) {
+        QMutexLocker locker(&m_mutex);
+        m_totalBytes -= m_index.take(key).size;
+    }
+    return data;
+}
+
+QByteArray IconCache::readFile(const QString &key) const
+{
+    QFile file(m_dir + "/" + key);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+// Never waits on the directory scan: one stat per path until the index is ready
+bool IconCache::isCached(const QString &path)
+{
+    const QString key = fileKey(path);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_indexed || m_index.contains(key)) {
+            return m_index.contains(key);
+        }
+    }
+    return QFile::exists(m_dir + "/" + key);
+}
+
+void IconCache::requestIcon(const QString &path)
+{
+    auto running = m_downloads.find(path);
+    if (running != m_downloads.end()) {
+        running->prefetch = false;  // Someone is waiting on it now
+        return;
+    }
+    
+    // Another request may have stored it since the caller missed
+    const QByteArray cached = readCached(path);
+    if (!cached.isEmpty()) {
+        emit iconAvailable(path, cached);
+        return;
+    }
+    
+    m_prefetchQueue.removeAll(path);
+    if (m_downloads.size() < MAX_CONCURRENT_DOWNLOADS) {
+        startDownload(path, false);
+    } else if (!m_demandQueue.contains(path)) {
+        m_demandQueue.append(path);
+    }
+}
+
+void IconCache::prefetch(const QStringList &paths)
+{
+    // Drop prefetches the new hint no longer asks for
+    m_prefetchQueue.clear();
+    const auto downloads = m_downloads;
+    for (auto it = downloads.cbegin(); it != downloads.cend(); ++it) {
+        if (it->prefetch && !paths.contains(it.key())) {
+            it->reply->abort();
+        }
+    }
+    
+    for (const QString &path : paths) {
+        if (path.isEmpty() || m_downloads.contains(path) || m_demandQueue.contains(path)
+            || m_prefetchQueue.contains(path) || isCached(path)) {
+            continue;
+        }
+        m_prefetchQueue.append(path);
+    }
+    startQueued();
+}
+
+void IconCache::startDownload(const QString &path, bool prefetch)
+{
+    QNetworkRequest request(iconUrl(path));
+    request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, QNetworkRequest::AlwaysNetwork);
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
+    request.setPriority(prefetch ? QNetworkRequest::LowPriority : QNetworkRequest::HighPriority);
+    
+    Download download;
+    download.reply = m_network.get(request);
+    download.reply->setProperty("iconPath", path);
+    download.prefetch = prefetch;
+    m_downloads.insert(path, download);
+}
+
+void IconCache::startQueued()
+{
+    while (m_downloads.size() < MAX_CONCURRENT_DOWNLOADS) {
+        if (!m_demandQueue.isEmpty()) {
+            startDownload(m_demandQueue.takeFirst(), false);
+        } else if (!m_prefetchQueue.isEmpty()) {
+            startDownload(m_prefetchQueue.takeFirst(), true);
+        } else {
+            break;
+        }
+    }
+}
+
+void IconCache::onDownloadFinished(QNetworkReply *reply)
+{
+    reply->deleteLater();
+    const QString path = reply->property("iconPath").toString();
+    m_downloads.remove(path);
+    startQueued();
+    
+    if (reply->error() == QNetworkReply::OperationCanceledError) {
+        return;  // Prefetch superseded by a newer hint, nobody was waiting on it
+    }
+    if (reply->error() != QNetworkReply::NoError) {
+        qWarning() << "Icon download failed:" << path << reply->errorString();
+        emit iconFailed(path, reply->errorString());
+        return;
+    }
+    
+    const QByteArray data = reply->readAll();
+    if (data.isEmpty()) {
+        emit iconFailed(path, "Empty response");
+        return;
+    }
+    
+    store(path, data);
+    emit iconAvailable(path, data);
+}
+
+void IconCache::store(const QString &path, const QByteArray &data)
+{
+    const QString key = fileKey(path);
+    QSaveFile file(m_dir + "/" + key);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Failed to write icon cache file:" << file.errorString();
+        return;
+    }
+    
+    QMutexLocker locker(&m_mutex);
+    Entry &entry = m_index[key];
+    m_totalBytes += data.size() - entry.size;
+    entry.size = data.size();
+    entry.lastUsed = QDateTime::currentMSecsSinceEpoch();
+    evict();
+}
+
+// Least recently used files go first until the cache fits its budget again (trimmed to 90%
+// so a full cache does not evict on every download)
+void IconCache::evict()
+{
+    if (!m_indexed || m_totalBytes <= m_maxBytes) {
+        return;
+    }
+    
+    QVector<QPair<qint64, QString>> byAge;
+    byAge.reserve(m_index.size());
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it) {
+        byAge.append({it->lastUsed, it.key()});
+    }
+    std::sort(byAge.begin(), byAge.end());
+    
+    const qint64 target = m_maxBytes * 9 / 10;
+    int removed = 0;
+    for (const auto &item : byAge) {
+        if (m_totalBytes <= target) {
+            break;
+        }
+        m_totalBytes -= m_index.take(item.second).size;
+        QFile::remove(m_dir + "/" + item.second);
+        ++removed;
+    }
+    qDebug() << "Icon cache evicted" << removed << "files," << m_totalBytes / 1024 << "KB left";
+}
+
+QVariantMap IconCache::memoryStats()
+{
+    QVariantMap stats;
+    {
+        QMutexLocker locker(&m_imageMutex);
+        // Costs are KB; reading them leaves the LRU order alone, unlike object()
+        stats["decoded"] = qint64(m_images.totalCost()) * 1024;
+        stats["decodedEntries"] = int(m_images.count());
+        qint64 pinnedBytes = 0;
+        for (const QImage &image : std::as_const(m_pinnedImages)) {
+            pinnedBytes += image.sizeInBytes();
+        }
+        stats["pinned"] = pinnedBytes;
+        stats["pinnedEntries"] = int(m_pinnedImages.size());
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        stats["disk"] = m_totalBytes;
+        stats["diskFiles"] = int(m_index.size());
+    }
+    return stats;
+}
+
+// Decode straight to the display size so the row keeps a small texture, not the full icon
+QImage IconCache::decode(const QByteArray &data, const QSize &size)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    QImageReader reader(&buffer);
+    const QSize fullSize = reader.size();
+    if (fullSize.isValid() && size.isValid() && !size.isEmpty()
+        && (fullSize.width() > size.width() || fullSize.height() > size.height())) {
+        reader.setScaledSize(fullSize.scaled(size, Qt::KeepAspectRatio));
+        reader.setQuality(100);  // Smooth scaling
+    }
+    return reader.read();
+}
+
+QString IconCache::atlasPath() const
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/icon-atlas.bin";
+}
+
+// Atlas layout: magic, version, payload size, SHA-1 of payload, payload
+// Payload: signature, entry count, (path, size, page, rect) per entry, pages
+void IconCache::loadAtlas()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    QFile file(atlasPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    
+    const qint64 headerSize = 4 + 4 + 8 + 20;
+    if (file.size() < headerSize) {
+        qWarning() << "Icon atlas is truncated, discarding it";
+        file.remove();
+        return;
+    }
+    
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        qWarning() << "Failed to map icon atlas:" << file.errorString();
+        return;
+    }
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size());
+    QDataStream header(bytes);
+    header.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 payloadSize = 0;
+    header >> magic >> version >> payloadSize;
+    
+    QByteArray signature;
+    QVector<QString> paths;
+    QVector<QSize> sizes;
+    QVector<qint32> pageIndexes;
+    QVector<QRect> rects;
+    QList<QImage> pages;
+    bool valid = false;
+    if (magic != ATLAS_MAGIC || version != ATLAS_VERSION) {
+        qDebug() << "Icon atlas has an old format, discarding it";
+    } else if (payloadSize != quint64(file.size() - headerSize)) {
+        qWarning() << "Icon atlas size mismatch, discarding it";
+    } else {
+        const QByteArray checksum = QByteArray::fromRawData(bytes.constData() + 16, 20);
+        const QByteArray payload = QByteArray::fromRawData(bytes.constData() + headerSize, payloadSize);
+        if (QCryptographicHash::hash(payload, QCryptographicHash::Sha1) != checksum) {
+            qWarning() << "Icon atlas checksum mismatch, discarding it";
+        } else {
+            QDataStream in(payload);
+            in.setVersion(QDataStream::Qt_6_0);
+            quint32 count = 0;
+            in >> signature >> count;
+            // Every entry takes at least ATLAS_MIN_ENTRY_BYTES, so a count beyond that is corrupt
+            if (count > quint64(in.device()->bytesAvailable()) / ATLAS_MIN_ENTRY_BYTES) {
+                qWarning() << "Icon atlas entry count" << count << "exceeds its size, discarding it";
+            } else {
+                paths.resize(count);
+                sizes.resize(count);
+                pageIndexes.resize(count);
+                rects.resize(count);
+                for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+                    in >> paths[i] >> sizes[i] >> pageIndexes[i] >> rects[i];
+                }
+                in >> pages;
+                valid = in.status() == QDataStream::Ok;
+                if (!valid) {
+                    qWarning() << "Icon atlas is malformed, discarding it";
+                }
+            }
+        }
+    }
+    
+    file.unmap(mapped);
+    if (!valid) {
+        file.close();
+        file.remove();
+        return;
+    }
+    
+    // Slice into the decoded cache and let the pages go
+    int seeded = 0;
+    for (int i = 0; i < paths.size(); ++i) {
+        if (pageIndexes[i] < 0 || pageIndexes[i] >= pages.size()
+            || !pages[pageIndexes[i]].rect().contains(rects[i])) {
+            continue;
+        }
+        insertDecodedImage(paths[i], sizes[i], pages[pageIndexes[i]].copy(rects[i]));
+        ++seeded;
+    }
+    m_atlasSignature = signature;
+    qDebug() << "Icon atlas:" << seeded << "icons from" << pages.size() << "pages in" << timer.elapsed() << "ms";
+}
+
+void IconCache::buildAtlas(const QList<AtlasGroup> &groups)
+{
+    m_atlasPool.start([this, groups]() {
+        QElapsedTimer timer;
+        timer.start();
+        
+        // Only icons that were downloaded already; the atlas never adds network traffic.
+        // indexDirectory() ran first on this single-thread pool.
+        struct Item {
+            QString key;  // imageKey(path, size)
+            QString path;
+            QSize size;
+        };
+        QVector<Item> items;
+        {
+            QMutexLocker locker(&m_mutex);
+            for (const AtlasGroup &group : groups) {
+                for (const QString &path : group.paths) {
+                    auto it = m_index.constFind(fileKey(path));
+                    if (it != m_index.constEnd()) {
+                        items.append({imageKey(path, group.size), path, group.size});
+                    }
+                }
+            }
+        }
+        if (items.isEmpty()) {
+            return;
+        }
+        // Ordered by key so the signature depends only on which icons are packed, not on
+        // when they were last shown (every read moves lastUsed)
+        std::sort(items.begin(), items.end(), [](const Item &a, const Item &b) {
+            return a.key < b.key;
+        });
+        items.erase(std::unique(items.begin(), items.end(), [](const Item &a, const Item &b) {
+            return a.key == b.key;
+        }), items.end());
+        
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        for (const Item &item : items) {
+            hash.addData(item.key.toUtf8());
+        }
+        const QByteArray signature = hash.result();
+        if (signature == m_atlasSignature) {
+            return;
+        }
+        
+        // Row packing: icons of one group share a size, so rows stay dense
+        QList<QImage> pages;
+        QVector<qint32> pageIndexes;
+        QVector<QRect> rects;
+        QVector<int> packed;
+        QImage page;
+        QPainter painter;
+        int x = 0;
+        int y = 0;
+        int rowHeight = 0;
+        int usedHeight = 0;
+        auto finishPage = [&]() {
+            if (!page.isNull()) {
+                painter.end();
+                pages.append(page.copy(0, 0, ATLAS_PAGE_SIZE, usedHeight));
+                page = QImage();
+            }
+        };
+        for (int i = 0; i < items.size(); ++i) {
+            // Packing is not a use: readCached() would make every atlas icon look recently used
+            const QByteArray data = readFile(fileKey(items[i].path));
+            const QImage image = data.isEmpty() ? QImage() : decode(data, items[i].size);
+            if (image.isNull() || image.width() > ATLAS_PAGE_SIZE || image.height() > ATLAS_PAGE_SIZE) {
+                continue;
+            }
+            if (x + image.width() > ATLAS_PAGE_SIZE) {
+                x = 0;
+                y += rowHeight;
+                rowHeight = 0;
+            }
+            if (page.isNull() || y + image.height() > ATLAS_PAGE_SIZE) {
+                finishPage();
+                page = QImage(ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE, QImage::Format_ARGB32_Premultiplied);
+                page.fill(Qt::transparent);
+                painter.begin(&page);
+                painter.setCompositionMode(QPainter::CompositionMode_Source);
+                x = 0;
+                y = 0;
+                rowHeight = 0;
+            }
+            painter.drawImage(x, y, image);
+            pageIndexes.append(pages.size());
+            rects.append(QRect(QPoint(x, y), image.size()));
+            packed.append(i);
+            x += image.width();
+            rowHeight = qMax(rowHeight, image.height());
+            usedHeight = y + rowHeight;
+        }
+        finishPage();
+        
+        QByteArray payload;
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << signature << quint32(packed.size());
+        for (int i = 0; i < packed.size(); ++i) {
+            const Item &item = items[packed[i]];
+            out << item.path << item.size << pageIndexes[i] << rects[i];
+        }
+        out << pages;
+        
+        QSaveFile file(atlasPath());
+        if (!file.open(QIODevice::WriteOnly)) {
+            qWarning() << "Failed to write icon atlas:" << file.errorString();
+            return;
+        }
+        QDataStream header(&file);
+        header.setVersion(QDataStream::Qt_6_0);
+        header << ATLAS_MAGIC << ATLAS_VERSION << quint64(payload.size());
+        file.write(QCryptographicHash::hash(payload, QCryptographicHash::Sha1));
+        file.write(payload);
+        if (out.status() != QDataStream::Ok || !file.commit()) {
+            qWarning() << "Failed to write icon atlas:" << file.errorString();
+            return;
+        }
+        
+        m_atlasSignature = signature;
+        qDebug() << "Icon atlas rebuilt:" << packed.size() << "icons on" << pages.size() << "pages in" << timer.elapsed() << "ms";
+    });
+}
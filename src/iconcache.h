@@ -0,0 +1,140 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QHash>
+#include <QSet>
+#include <QCache>
+#include <QImage>
+#include <QSize>
+#include <QMutex>
+#include <QThreadPool>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+#include <QUrl>
+#include <QVariantMap>
+
+// Persistent cache of bungie.net icons, keyed by icon path (e.g. "/common/destiny2_content/icons/...").
+// Files are stored under the SHA-1 of the path; Bungie paths already change when the image changes.
+// Lives on the GUI thread; readCached() may be called from any thread.
+class IconCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IconCache(QObject *parent = nullptr);
+    ~IconCache() override;
+
+    // Icon bytes from disk, or empty on a miss. Marks the entry as recently used.
+    QByteArray readCached(const QString &path);
+
+    // Download an icon that is not on disk yet. Emits iconAvailable or iconFailed.
+    // Jumps ahead of prefetches and is never cancelled by them.
+    Q_INVOKABLE void requestIcon(const QString &path);
+
+    // Icons the view is likely to show next, most urgent first. Replaces the previous hint:
+    // queued and in-flight prefetches that are no longer listed are dropped.
+    void prefetch(const QStringList &paths);
+
+    static QUrl iconUrl(const QString &path);
+
+    // Process-wide decoded images, keyed by path and display size (any thread).
+    // Returns a null image on a miss.
+    QImage decodedImage(const QString &path, const QSize &size);
+    void insertDecodedImage(const QString &path, const QSize &size, const QImage &image);
+
+    // Decode (downloading first if needed) into the decoded images for painters that cannot wait
+    // on an image response. Emits decodedImageReady once decodedImage() has it.
+    void requestDecoded(const QString &path, const QSize &size);
+
+    // Pool for every decode that touches this cache; drained in ~IconCache, so tasks on it
+    // may capture the cache
+    QThreadPool *decodePool() { return &m_decodePool; }
+
+    // Icons shared by many rows (damage and ammo types) stay decoded for the whole session
+    void setPinnedIcons(const QStringList &paths);
+
+    // Decode icon bytes, downscaled to fit size when the image is larger (any thread)
+    static QImage decode(const QByteArray &data, const QSize &size);
+
+    // Icons to pack into the atlas, all at one requested size (device pixels, as the provider sees it)
+    struct AtlasGroup {
+        QStringList paths;
+        QSize size;
+    };
+
+    // Packs every listed icon that is already on disk into one atlas file in the background
+    // (skipped when the set has not changed). The next launch seeds the decoded images from it
+    // with one read and one decode per page instead of one per icon.
+    void buildAtlas(const QList<AtlasGroup> &groups);
+
+    // Approximate bytes of decoded images (decoded, pinned) and files on disk (disk), with entry counts
+    Q_INVOKABLE QVariantMap memoryStats();
+
+signals:
+    void iconAvailable(const QString &path, const QByteArray &data);
+    void iconFailed(const QString &path, const QString &error);
+    void decodedImageReady(const QString &path);
+
+private slots:
+    void onDownloadFinished(QNetworkReply *reply);
+
+private:
+    struct Download {
+        QNetworkReply *reply = nullptr;
+        bool prefetch = false;  // Nobody waits on it yet, may be cancelled by a newer hint
+    };
+
+    struct Entry {
+        qint64 size = 0;
+        qint64 lastUsed = 0;  // Msecs since epoch; starts at the file's write time
+    };
+
+    static QString fileKey(const QString &path);
+    static QString imageKey(const QString &path, const QSize &size);
+    bool isCached(const QString &path);
+    QByteArray readFile(const QString &key) const;  // Leaves the index and LRU order alone
+    void startDownload(const QString &path, bool prefetch);
+    void startQueued();
+    void decodeInBackground(const QString &path, const QSize &size, const QByteArray &data);
+    void indexDirectory();  // Atlas pool, once at construction
+    void store(const QString &path, const QByteArray &data);
+    void evict();           // Caller holds m_mutex; waits for the index
+    void loadAtlas();       // Atlas pool only
+    QString atlasPath() const;
+
+    QNetworkAccessManager m_network;
+    QHash<QString, Download> m_downloads;  // In flight, by icon path
+    QStringList m_demandQueue;            // Waiting for a free slot, visible rows first
+    QStringList m_prefetchQueue;
+
+    QMutex m_mutex;                  // Guards the index below
+    QString m_dir;
+    QHash<QString, Entry> m_index;   // By file key
+    qint64 m_totalBytes = 0;
+    qint64 m_maxBytes = 0;
+    bool m_indexed = false;          // Set once indexDirectory() has merged the scan
+
+    QMutex m_imageMutex;             // Guards the decoded images below
+    QCache<QString, QImage> m_images;  // Cost in KB, bounded by iconMemoryMB
+    QHash<QString, QImage> m_pinnedImages;
+    QSet<QString> m_pinnedPaths;
+    QMultiHash<QString, QSize> m_pendingDecodes;  // requestDecoded() calls waiting, by path (GUI thread)
+
+    QThreadPool m_decodePool;        // Decodes (requestDecoded, image provider), drained before the cache goes away
+    QThreadPool m_atlasPool;         // One idle-priority thread, loads then rebuilds the atlas
+    QByteArray m_atlasSignature;     // SHA-1 of the packed keys, only touched on the atlas pool
+
+    static const int DEFAULT_DISK_BUDGET_MB = 64;
+    static const int DEFAULT_MEMORY_BUDGET_MB = 24;
+    static const int MAX_CONCURRENT_DOWNLOADS = 6;  // Multiplexed on one connection when bungie.net speaks HTTP/2
+    static const int ATLAS_PAGE_SIZE = 2048;
+    static const quint32 ATLAS_MAGIC = 0x47524941;  // "GRIA"
+    static const quint32 ATLAS_VERSION = 2;
+    static const int ATLAS_MIN_ENTRY_BYTES = 4 + 8 + 4 + 16;  // Empty path, size, page, rect
+};
+
+#endif // ICONCACHE_H
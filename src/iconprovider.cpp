@@ -0,0 +1,110 @@
+#include "iconprovider.h"
+#include "iconcache.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+
+IconProvider::IconProvider(IconCache *cache)
+    : m_cache(cache)
+{
+}
+
+QQuickImageResponse *IconProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    // id is the icon path without its leading slash
+    return new IconResponse("/" + id, requestedSize, m_cache);
+}
+
+IconResponse::IconResponse(const QString &path, const QSize &requestedSize, IconCache *cache)
+    : m_path(path)
+    , m_requestedSize(requestedSize)
+    , m_cache(cache)
+    , m_watcher(new QFutureWatcher<Decoded>(this))
+{
+    connect(m_watcher, &QFutureWatcher<Decoded>::finished, this, &IconResponse::onDecoded);
+    
+    // Already decoded at this size by another row: finish without touching disk or the pool
+    // (queued, the engine connects to finished() only after this returns)
+    m_image = m_cache->decodedImage(m_path, m_requestedSize);
+    if (!m_image.isNull()) {
+        QMetaObject::invokeMethod(this, [this]() { finish(); }, Qt::QueuedConnection);
+        return;
+    }
+    
+    // Disk read and decode both happen on the pool; only a miss goes to the network
+    startDecode(QByteArray());
+}
+
+void IconResponse::startDecode(const QByteArray &data)
+{
+    IconCache *cache = m_cache;
+    const QString path = m_path;
+    const QSize requestedSize = m_requestedSize;
+    m_watcher->setFuture(QtConcurrent::run(cache->decodePool(), [cache, path, requestedSize, data]() {
+        Decoded result;
+        const QByteArray bytes = data.isEmpty() ? cache->readCached(path) : data;
+        if (bytes.isEmpty()) {
+            result.miss = true;
+        } else {
+            result.image = IconCache::decode(bytes, requestedSize);
+            cache->insertDecodedImage(path, requestedSize, result.image);
+        }
+        return result;
+    }));
+}
+
+void IconResponse::onDecoded()
+{
+    if (m_finished) {
+        return;
+    }
+    if (m_cancelled) {
+        finish(QStringLiteral("Cancelled"));
+        return;
+    }
+    
+    const Decoded result = m_watcher->result();
+    if (!result.miss) {
+        m_image = result.image;
+        finish(m_image.isNull() ? QString("Failed to decode %1").arg(m_path) : QString());
+        return;
+    }
+    
+    // Not on disk: ask the cache (GUI thread) to download it and wait for the bytes
+    connect(m_cache, &IconCache::iconAvailable, this, [this](const QString &path, const QByteArray &data) {
+        if (path == m_path && !m_finished) {
+            disconnect(m_cache, nullptr, this, nullptr);
+            startDecode(data);
+        }
+    });
+    connect(m_cache, &IconCache::iconFailed, this, [this](const QString &path, const QString &error) {
+        if (path == m_path) {
+            finish(error);
+        }
+    });
+    QMetaObject::invokeMethod(m_cache, "requestIcon", Qt::QueuedConnection, Q_ARG(QString, m_path));
+}
+
+void IconResponse::finish(const QString &error)
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_error = error;
+    disconnect(m_cache, nullptr, this, nullptr);
+    emit finished();
+}
+
+// A running decode still uses the cache and its result; finished() waits for onDecoded()
+void IconResponse::cancel()
+{
+    m_cancelled = true;
+    if (!m_watcher->isRunning()) {
+        finish(QStringLiteral("Cancelled"));
+    }
+}
+
+QQuickTextureFactory *IconResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
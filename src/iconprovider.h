@@ -0,0 +1,56 @@
+#ifndef ICONPROVIDER_H
+#define ICONPROVIDER_H
+
+#include <QQuickAsyncImageProvider>
+#include <QQuickImageResponse>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QSize>
+
+class IconCache;
+
+// Serves image://icons/<bungie.net icon path> from IconCache, decoding on worker threads
+class IconProvider : public QQuickAsyncImageProvider
+{
+public:
+    explicit IconProvider(IconCache *cache);
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    IconCache *m_cache;
+};
+
+class IconResponse : public QQuickImageResponse
+{
+    Q_OBJECT
+
+public:
+    IconResponse(const QString &path, const QSize &requestedSize, IconCache *cache);
+
+    QQuickTextureFactory *textureFactory() const override;
+    QString errorString() const override { return m_error; }
+    void cancel() override;
+
+private:
+    // Result of one worker pass: the decoded image, or a disk miss that needs a download
+    struct Decoded {
+        QImage image;
+        bool miss = false;
+    };
+
+    void startDecode(const QByteArray &data);
+    void onDecoded();
+    void finish(const QString &error = QString());
+
+    QString m_path;
+    QSize m_requestedSize;
+    IconCache *m_cache;
+    QFutureWatcher<Decoded> *m_watcher;
+    QImage m_image;
+    QString m_error;
+    bool m_cancelled = false;
+    bool m_finished = false;
+};
+
+#endif // ICONPROVIDER_H
@@ -0,0 +1,232 @@
+#include "latencytracer.h"
+#include <QQuickWindow>
+#include <QKeyEvent>
+#include <QKeySequence>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QDebug>
+#include <algorithm>
+
+LatencyTracer::LatencyTracer(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+void LatencyTracer::attach(QQuickWindow *window)
+{
+    m_window = window;
+    window->installEventFilter(this);
+    
+    // Frame signals come from the render thread: timestamp there, account on the GUI thread
+    connect(window, &QQuickWindow::beforeSynchronizing, this, [this]() {
+        m_syncStart.storeRelaxed(now());
+    }, Qt::DirectConnection);
+    connect(window, &QQuickWindow::frameSwapped, this, [this]() {
+        const qint64 syncStart = m_syncStart.loadRelaxed();
+        const qint64 swapped = now();
+        QMetaObject::invokeMethod(this, [this, syncStart, swapped]() {
+            onFrameSwapped(syncStart, swapped);
+        }, Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+}
+
+void LatencyTracer::suspend()
+{
+    m_suspended = true;
+}
+
+void LatencyTracer::resume()
+{
+    m_suspended = false;
+    m_resumedAt = now();
+}
+
+void LatencyTracer::markHotkey()
+{
+    const qint64 time = now();
+    addEvent("hotkey", "input", time);
+    
+    // The same hotkey hides a shown window; only a hidden one has a "to visible" to measure.
+    // A window shown only for a pre-warm render counts as hidden.
+    if (!m_window || !m_window->isVisible() || m_suspended) {
+        m_hotkeyPressed = time;
+    }
+}
+
+void LatencyTracer::markQuery()
+{
+    addEvent("query changed", "model", now());
+}
+
+void LatencyTracer::markResults()
+{
+    const qint64 time = now();
+    for (Keystroke &key : m_pendingKeys) {
+        if (key.results == 0) {
+            key.results = time;
+            addEvent("search " + key.key, "model", key.pressed, time - key.pressed);
+        }
+    }
+}
+
+bool LatencyTracer::eventFilter(QObject *watched, QEvent *event)
+{
+    // Keys (or a hotkey) that closed the window never get a visible frame. The hide ending a
+    // pre-warm render is not the user's, a hotkey that cut it short still shows the window.
+    if (event->type() == QEvent::Hide && !m_suspended) {
+        m_pendingKeys.clear();
+        m_hotkeyPressed = 0;
+    }
+    if (event->type() == QEvent::KeyPress && m_pendingKeys.size() < MAX_SAMPLES) {
+        const auto *keyEvent = static_cast<QKeyEvent *>(event);
+        Keystroke key;
+        key.pressed = now();
+        key.key = keyEvent->text().isEmpty() ? QKeySequence(keyEvent->key()).toString() : keyEvent->text();
+        m_pendingKeys.append(key);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void LatencyTracer::onFrameSwapped(qint64 syncStart, qint64 swapped)
+{
+    // Pre-warm renders are invisible; frames synchronized before resume() are theirs too
+    if (!m_window || !m_window->isVisible() || m_suspended || syncStart < m_resumedAt) {
+        return;
+    }
+    
+    m_frameSamples.add(swapped - syncStart);
+    addEvent("frame", "render", syncStart, swapped - syncStart);
+    
+    // Only frames synchronized after an input can show its effect
+    if (m_hotkeyPressed > 0 && syncStart >= m_hotkeyPressed) {
+        m_hotkeySamples.add(swapped - m_hotkeyPressed);
+        addEvent("hotkey to visible", "latency", m_hotkeyPressed, swapped - m_hotkeyPressed);
+        m_hotkeyPressed = 0;
+    }
+    
+    for (int i = 0; i < m_pendingKeys.size();) {
+        const Keystroke &key = m_pendingKeys[i];
+        if (syncStart >= qMax(key.pressed, key.results)) {
+            m_keystrokeSamples.add(swapped - key.pressed);
+            addEvent("keystroke " + key.key, "latency", key.pressed, swapped - key.pressed);
+            m_pendingKeys.removeAt(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+void LatencyTracer::addEvent(const QString &name, const char *category, qint64 start, qint64 duration)
+{
+    const TraceEvent event{name, category, start, duration};
+    if (m_events.size() < MAX_TRACE_EVENTS) {
+        m_events.append(event);
+    } else {
+        m_events[m_nextEvent] = event;
+        m_nextEvent = (m_nextEvent + 1) % MAX_TRACE_EVENTS;
+    }
+}
+
+void LatencyTracer::Samples::add(qint64 value)
+{
+    if (values.size() < MAX_SAMPLES) {
+        values.append(value);
+    } else {
+        values[next] = value;
+        next = (next + 1) % MAX_SAMPLES;
+    }
+    ++total;
+}
+
+QVariantMap LatencyTracer::Samples::percentiles() const
+{
+    QVariantMap result;
+    result["count"] = total;
+    if (values.isEmpty()) {
+        return result;
+    }
+    QVector<qint64> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+    auto at = [&sorted](double p) {
+        return sorted[qMin(int(sorted.size() - 1), int(p * sorted.size()))] / 1000.0;
+    };
+    result["p50"] = at(0.50);
+    result["p90"] = at(0.90);
+    result["p99"] = at(0.99);
+    result["max"] = sorted.last() / 1000.0;
+    return result;
+}
+
+QVariantMap LatencyTracer::stats() const
+{
+    QVariantMap stats;
+    stats["hotkeyToVisible"] = m_hotkeySamples.percentiles();
+    stats["keystroke"] = m_keystrokeSamples.percentiles();
+    stats["frame"] = m_frameSamples.percentiles();
+    return stats;
+}
+
+void LatencyTracer::logStats() const
+{
+    const QVariantMap all = stats();
+    for (auto it = all.cbegin(); it != all.cend(); ++it) {
+        const QVariantMap metric = it.value().toMap();
+        qDebug().noquote() << "Latency" << it.key() << "(n=" << metric["count"].toLongLong() << "):"
+                           << "p50" << metric["p50"].toDouble() << "ms,"
+                           << "p90" << metric["p90"].toDouble() << "ms,"
+                           << "p99" << metric["p99"].toDouble() << "ms,"
+                           << "max" << metric["max"].toDouble() << "ms";
+    }
+}
+
+// Chrome trace event format: complete ("X") events with ts/dur in microseconds, instants ("i")
+QString LatencyTracer::exportTrace() const
+{
+    QJsonArray events;
+    const int count = m_events.size();
+    for (int i = 0; i < count; ++i) {
+        const TraceEvent &event = m_events[(m_nextEvent + i) % count];
+        QJsonObject object;
+        object["name"] = event.name;
+        object["cat"] = QString::fromLatin1(event.category);
+        object["ts"] = double(event.start);
+        object["pid"] = 1;
+        object["tid"] = QString::fromLatin1(event.category) == "render" ? 2 : 1;
+        if (event.duration >= 0) {
+            object["ph"] = "X";
+            object["dur"] = double(event.duration);
+        } else {
+            object["ph"] = "i";
+            object["s"] = "t";
+        }
+        events.append(object);
+    }
+    
+    QJsonObject trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    QJsonObject metadata;
+    metadata["app"] = QCoreApplication::applicationName();
+    metadata["version"] = QCoreApplication::applicationVersion();
+    metadata["stats"] = QJsonObject::fromVariantMap(stats());
+    trace["metadata"] = metadata;
+    
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    QSaveFile file(dir + "/trace.json");
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0
+        || !file.commit()) {
+        qWarning() << "Failed to write trace:" << file.errorString();
+        return QString();
+    }
+    qDebug() << "Wrote" << count << "trace events to" << file.fileName();
+    logStats();
+    return file.fileName();
+}
@@ -0,0 +1,93 @@
+#ifndef LATENCYTRACER_H
+#define LATENCYTRACER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QVariantMap>
+#include <QVector>
+#include <QString>
+#include <QAtomicInteger>
+#include <QPointer>
+
+class QQuickWindow;
+
+// Perceived latency, measured to the swapped frame:
+// - hotkeyToVisible: GlobalHotkey::activated until the first frame of the shown window
+// - keystroke: key press in the window until the first frame rendered after its results
+// - frame: sync + render + swap time of each frame while the window is shown
+// Keeps rolling percentiles and a bounded Chrome trace (chrome://tracing, Perfetto) for export.
+class LatencyTracer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyTracer(QObject *parent = nullptr);
+
+    void attach(QQuickWindow *window);
+
+    // p50/p90/p99/max in milliseconds and sample count per metric
+    Q_INVOKABLE QVariantMap stats() const;
+    Q_INVOKABLE void logStats() const;
+
+    // Writes trace.json to the app data folder and returns its path (empty on failure)
+    Q_INVOKABLE QString exportTrace() const;
+
+public slots:
+    void markHotkey();
+    void markQuery();
+    void markResults();
+
+    // Ignore frames while the window renders without being seen (WindowWarmer)
+    void suspend();
+    void resume();
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    // Fixed-size window of the most recent samples (microseconds)
+    struct Samples {
+        QVector<qint64> values;
+        int next = 0;
+        qint64 total = 0;  // All samples ever, for the count
+
+        void add(qint64 value);
+        QVariantMap percentiles() const;
+    };
+
+    struct Keystroke {
+        qint64 pressed = 0;
+        qint64 results = 0;  // 0 until the model published results for it (if it changed them)
+        QString key;
+    };
+
+    struct TraceEvent {
+        QString name;
+        const char *category;
+        qint64 start;
+        qint64 duration;  // -1 for an instant event
+    };
+
+    qint64 now() const { return m_clock.nsecsElapsed() / 1000; }
+    void onFrameSwapped(qint64 syncStart, qint64 swapped);
+    void addEvent(const QString &name, const char *category, qint64 start, qint64 duration = -1);
+
+    QElapsedTimer m_clock;
+    QPointer<QQuickWindow> m_window;
+    QAtomicInteger<qint64> m_syncStart = 0;  // Written on the render thread
+
+    bool m_suspended = false;
+    qint64 m_resumedAt = 0;
+    qint64 m_hotkeyPressed = 0;
+    QVector<Keystroke> m_pendingKeys;
+    Samples m_hotkeySamples;
+    Samples m_keystrokeSamples;
+    Samples m_frameSamples;
+    QVector<TraceEvent> m_events;  // Ring buffer
+    int m_nextEvent = 0;
+
+    static const int MAX_SAMPLES = 512;
+    static const int MAX_TRACE_EVENTS = 20000;
+};
+
+#endif // LATENCYTRACER_H
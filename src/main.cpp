@@ -4,19 +4,43 @@
 #include <QFontDatabase>
 #include <QSharedMemory>
 #include <QMessageBox>
+#include <QSettings>
+#include <QtQml>
 #include "weaponsearchmodel.h"
 #include "globalhotkey.h"
 #include "weaponloader.h"
 #include "trayicon.h"
 #include "updatechecker.h"
+#include "iconcache.h"
+#include "iconprovider.h"
+#include "weaponrow.h"
+#include "latencytracer.h"
+#include "windowwarmer.h"
+#include "startupprofiler.h"
+#include <QQuickWindow>
+#include <QTimer>
+#include <memory>
 
 // Version from CMake
 #ifndef APP_VERSION
 #define APP_VERSION "1.0.0"
 #endif
 
+// Non-critical setup (tray menu, update checker) waits for the first catalog, or this long at most
+static const int DEFERRED_INIT_TIMEOUT_MS = 1500;
+
 int main(int argc, char *argv[])
 {
+    // Startup timeline: --startup-trace (or GODROLL_STARTUP_TRACE=1) writes startup-trace.json
+    bool startupTrace = qEnvironmentVariableIntValue("GODROLL_STARTUP_TRACE") != 0;
+    for (int i = 1; i < argc; ++i) {
+        if (QString(argv[i]) == "--startup-trace") {
+            startupTrace = true;
+            break;
+        }
+    }
+    StartupProfiler::start(startupTrace);
+    
     qDebug() << "Starting Godroll Launcher v" << APP_VERSION;
     
     QApplication app(argc, argv);
@@ -25,6 +49,7 @@ int main(int argc, char *argv[])
     app.setApplicationVersion(APP_VERSION);
     app.setOrganizationName("Godroll.tv");
     app.setQuitOnLastWindowClosed(false); // Keep running in background
+    StartupProfiler::mark("QApplication");
 
     // Single instance check using shared memory
     QSharedMemory sharedMemory("GodrollLauncherSingleInstance");
@@ -44,6 +69,15 @@ int main(int argc, char *argv[])
     }
     qDebug() << "Start hidden:" << startHidden;
 
+    // Optional weapons endpoint override for development: --api-url <url>
+    QString apiUrl;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (QString(argv[i]) == "--api-url") {
+            apiUrl = QString(argv[i + 1]);
+            break;
+        }
+    }
+
     // Load custom font
     int fontId = QFontDatabase::addApplicationFont(":/qt/qml/GodrollLauncher/resources/fonts/SpaceGrotesk.ttf");
     if (fontId != -1) {
@@ -52,15 +86,22 @@ int main(int argc, char *argv[])
     } else {
         qDebug() << "Failed to load Space Grotesk font";
     }
+    StartupProfiler::mark("Font");
 
     qDebug() << "App initialized";
 
     // Initialize components
     WeaponLoader weaponLoader;
+    if (!apiUrl.isEmpty()) {
+        weaponLoader.setEndpoint(QUrl(apiUrl));
+    }
     WeaponSearchModel searchModel;
     GlobalHotkey hotkey;
+    StartupProfiler::mark("Hotkey registered");
     TrayIcon trayIcon;
-    UpdateChecker updateChecker;
+    IconCache iconCache;
+    LatencyTracer latencyTracer;
+    WindowWarmer windowWarmer;
     
     // Show tray icon
     trayIcon.show();
@@ -69,26 +110,70 @@ int main(int argc, char *argv[])
     QObject::connect(&trayIcon, &TrayIcon::exitRequested, &app, &QApplication::quit);
     
     qDebug() << "Components created";
+    StartupProfiler::mark("Components");
+    
+    // Latency instrumentation: input and model marks, frames once the window exists
+    QObject::connect(&hotkey, &GlobalHotkey::activated, &latencyTracer, &LatencyTracer::markHotkey);
+    QObject::connect(&searchModel, &WeaponSearchModel::searchQueryChanged, &latencyTracer, &LatencyTracer::markQuery);
+    QObject::connect(&searchModel, &QAbstractItemModel::modelReset, &latencyTracer, &LatencyTracer::markResults);
 
-    // Load weapons from API
-    weaponLoader.loadWeapons([&searchModel](const QJsonArray& weapons) {
-        searchModel.setWeapons(weapons);
+    // Searchable once the hotkey is registered and the first catalog (usually the cached snapshot)
+    // is in the model
+    bool catalogLoaded = false;
+    QObject::connect(&searchModel, &WeaponSearchModel::weaponsLoaded, &app, [&catalogLoaded]() {
+        catalogLoaded = true;
+    });
+    
+    // Load weapons (cached snapshot first, then API)
+    weaponLoader.loadWeapons([&searchModel](const WeaponCatalogPtr& catalog) {
+        searchModel.setCatalog(catalog);
     });
+    StartupProfiler::mark("Catalog snapshot");
     
     // Connect reload signal to update search model
-    QObject::connect(&weaponLoader, &WeaponLoader::weaponsLoaded, 
-                     &searchModel, &WeaponSearchModel::setWeapons);
+    QObject::connect(&weaponLoader, &WeaponLoader::catalogLoaded, 
+                     &searchModel, &WeaponSearchModel::setCatalog);
+    
+    // Download icons for new results before their rows are created
+    QObject::connect(&searchModel, &WeaponSearchModel::iconsWanted,
+                     &iconCache, &IconCache::prefetch);
+    QObject::connect(&searchModel, &WeaponSearchModel::weaponsLoaded, &iconCache, [&]() {
+        const QStringList sharedIcons = searchModel.sharedIconPaths();
+        iconCache.setPinnedIcons(sharedIcons);
+        
+        // Repack the downloaded icons for the next launch, at the sizes WeaponItem.qml requests
+        // (sourceSize scaled by the device pixel ratio, as Qt Quick passes it to the provider)
+        const qreal dpr = app.devicePixelRatio();
+        iconCache.buildAtlas({
+            {searchModel.weaponIconPaths(), QSize(52, 52) * dpr},
+            {sharedIcons, QSize(18, 18) * dpr}
+        });
+    });
 
+    // Created after startup, outlives the engine that references it
+    std::unique_ptr<UpdateChecker> updateChecker;
     QQmlApplicationEngine engine;
     
+    // Weapon, damage and ammo icons load through image://icons (disk-cached, decoded off the GUI thread)
+    engine.addImageProvider("icons", new IconProvider(&iconCache));
+    
+    // Optional scene graph result rows (nativeRows setting), drawing from the same icon cache
+    WeaponRow::setIconCache(&iconCache);
+    qmlRegisterType<WeaponRow>("GodrollLauncher.Native", 1, 0, "WeaponRow");
+    const bool useNativeRows = QSettings("Godroll.tv", "GodrollLauncher").value("nativeRows", false).toBool();
+    
     // Expose C++ objects to QML
     engine.rootContext()->setContextProperty("searchModel", &searchModel);
     engine.rootContext()->setContextProperty("hotkey", &hotkey);
     engine.rootContext()->setContextProperty("trayIcon", &trayIcon);
     engine.rootContext()->setContextProperty("weaponLoader", &weaponLoader);
-    engine.rootContext()->setContextProperty("updateChecker", &updateChecker);
+    engine.rootContext()->setContextProperty("updateChecker", QVariant::fromValue<QObject *>(nullptr));
     engine.rootContext()->setContextProperty("startHidden", startHidden);
     engine.rootContext()->setContextProperty("appVersion", APP_VERSION);
+    engine.rootContext()->setContextProperty("useNativeRows", useNativeRows);
+    engine.rootContext()->setContextProperty("latencyTracer", &latencyTracer);
+    engine.rootContext()->setContextProperty("iconCache", &iconCache);
+    engine.rootContext()->setContextProperty("windowWarmer", &windowWarmer);
 
     const QUrl url(QStringLiteral("qrc:/qt/qml/GodrollLauncher/qml/main.qml"));
     
@@ -102,8 +187,56 @@ int main(int argc, char *argv[])
         }
     }, Qt::QueuedConnection);
 
+    StartupProfiler::mark("Engine setup");
     qDebug() << "Loading QML from:" << url;
     engine.load(url);
+    StartupProfiler::mark("QML loaded");
+    
+    if (!engine.rootObjects().isEmpty()) {
+        if (auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().first())) {
+            latencyTracer.attach(window);
+            windowWarmer.attach(window);
+            QObject::connect(&windowWarmer, &WindowWarmer::warmingChanged, &latencyTracer, [&]() {
+                if (windowWarmer.warming()) {
+                    latencyTracer.suspend();
+                } else {
+                    latencyTracer.resume();
+                }
+            });
+            
+            // Render the hidden window once now and again whenever a new catalog changes its rows
+            QTimer::singleShot(0, &windowWarmer, &WindowWarmer::warm);
+            QObject::connect(&searchModel, &WeaponSearchModel::weaponsLoaded,
+                             &windowWarmer, &WindowWarmer::warm, Qt::QueuedConnection);
+        }
+    }
+
+    // Everything the first search does not need is set up once the app is searchable
+    bool deferredDone = false;
+    auto finishStartup = [&]() {
+        if (deferredDone) {
+            return;
+        }
+        deferredDone = true;
+        StartupProfiler::mark(catalogLoaded ? "Searchable" : "Waiting for catalog");
+        if (catalogLoaded) {
+            qDebug() << "Searchable after" << StartupProfiler::elapsed() << "ms";
+        }
+        
+        trayIcon.finishSetup();
+        StartupProfiler::mark("Tray menu");
+        
+        updateChecker = std::make_unique<UpdateChecker>();
+        engine.rootContext()->setContextProperty("updateChecker", updateChecker.get());
+        StartupProfiler::mark("Update checker");
+        StartupProfiler::finish();
+    };
+    if (catalogLoaded) {
+        QTimer::singleShot(0, &app, finishStartup);
+    } else {
+        QObject::connect(&searchModel, &WeaponSearchModel::weaponsLoaded, &app, finishStartup, Qt::QueuedConnection);
+        QTimer::singleShot(DEFERRED_INIT_TIMEOUT_MS, &app, finishStartup);
+    }
 
     return app.exec();
 }
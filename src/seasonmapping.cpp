@@ -0,0 +1,205 @@
+#include "seasonmapping.h"
+#include <QFile>
+#include <QStandardPaths>
+#include <QMutexLocker>
+#include <QDebug>
+#include <algorithm>
+#include <iterator>
+
+constexpr bool isSeasonTableSorted()
+{
+    for (size_t i = 1; i < std::size(SEASON_TABLE); ++i) {
+        if (SEASON_TABLE[i - 1].version >= SEASON_TABLE[i].version) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(isSeasonTableSorted(), "SEASON_TABLE must be sorted by version without duplicates");
+
+static SeasonInfo makeSeasonInfo(int version, const QString &name, int number,
+                                 const QString &expansion, const QString &type)
+{
+    SeasonInfo info;
+    info.identifier = QString("v%1").arg(version);
+    info.name = name;
+    info.number = number;
+    info.expansion = expansion;
+    info.type = type;
+    info.shortName = !info.name.isEmpty() ? info.name : info.expansion;
+    info.display = info.displayName();
+    return info;
+}
+
+SeasonMapping::SeasonMapping()
+{
+    initSeasons();
+}
+
+// Strings are built once here, lookups only return pointers into m_seasons
+void SeasonMapping::initSeasons()
+{
+    m_seasons.reserve(std::size(SEASON_TABLE));
+    for (const SeasonEntry &entry : SEASON_TABLE) {
+        m_seasons.append(makeSeasonInfo(entry.version,
+                                        QString::fromUtf8(entry.name),
+                                        entry.number,
+                                        QString::fromUtf8(entry.expansion),
+                                        QString::fromUtf8(entry.type)));
+    }
+}
+
+const SeasonInfo *SeasonMapping::resolve(const QJsonArray& traitIds) const
+{
+    static const QLatin1String prefix("releases.v");
+    for (const auto& trait : traitIds) {
+        const QString traitId = trait.toString();
+        if (!traitId.startsWith(prefix)) {
+            continue;
+        }
+
+        // Parse the digits in place: "releases.v300.annual" -> 300
+        int version = 0;
+        int pos = prefix.size();
+        while (pos < traitId.size() && traitId[pos].isDigit()) {
+            version = version * 10 + traitId[pos].digitValue();
+            ++pos;
+        }
+        if (pos == prefix.size() || (pos < traitId.size() && traitId[pos] != QLatin1Char('.'))) {
+            continue;
+        }
+
+        if (const SeasonInfo *info = findVersion(version)) {
+            return info;
+        }
+        if (const SeasonInfo *info = findOverride(version)) {
+            return info;
+        }
+    }
+    return nullptr;
+}
+
+const SeasonInfo *SeasonMapping::findVersion(int version) const
+{
+    const SeasonEntry *begin = std::begin(SEASON_TABLE);
+    const SeasonEntry *end = std::end(SEASON_TABLE);
+    const SeasonEntry *it = std::lower_bound(begin, end, version,
+        [](const SeasonEntry &entry, int value) { return entry.version < value; });
+    if (it == end || it->version != version) {
+        return nullptr;
+    }
+    return &m_seasons[it - begin];
+}
+
+const SeasonInfo *SeasonMapping::findOverride(int version) const
+{
+    // Resolution runs on loader worker threads; m_overrides is never modified after loading,
+    // so returned pointers stay valid
+    QMutexLocker locker(&m_overrideMutex);
+    if (!m_overridesLoaded) {
+        m_overridesLoaded = true;
+        loadOverrides();
+    }
+    auto it = m_overrides.constFind(version);
+    return it != m_overrides.constEnd() ? &it.value() : nullptr;
+}
+
+QString SeasonMapping::overridePath()
+{
+    if (qEnvironmentVariableIsSet("GODROLL_SEASONS_FILE")) {
+        return qEnvironmentVariable("GODROLL_SEASONS_FILE");
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/seasons.csv";
+}
+
+QList<QByteArray> SeasonMapping::splitCsvLine(const QByteArray &line)
+{
+    QList<QByteArray> fields;
+    int pos = 0;
+    while (true) {
+        QByteArray field;
+        if (pos < line.size() && line[pos] == '"') {
+            ++pos;
+            while (true) {
+                const int quote = line.indexOf('"', pos);
+                if (quote < 0) {
+                    return {};
+                }
+                field += line.mid(pos, quote - pos);
+                pos = quote + 1;
+                if (pos < line.size() && line[pos] == '"') {
+                    field += '"';
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+            if (pos < line.size() && line[pos] != ',') {
+                return {};
+            }
+        } else {
+            const int comma = line.indexOf(',', pos);
+            const int end = comma < 0 ? line.size() : comma;
+            field = line.mid(pos, end - pos);
+            pos = end;
+        }
+        fields.append(field);
+        if (pos >= line.size()) {
+            return fields;
+        }
+        ++pos;  // Skip the comma
+    }
+}
+
+void SeasonMapping::loadOverrides() const
+{
+    QFile file(overridePath());
+    if (!file.exists() || !file.open(QIODevice::ReadOnly) || file.size() == 0) {
+        return;
+    }
+    
+    uchar *mapped = file.map(0, file.size());
+    if (!mapped) {
+        qWarning() << "Failed to map season overrides:" << file.errorString();
+        return;
+    }
+    
+    // version,number,type,expansion,name per line; '#' comments and the header row are skipped
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(mapped), file.size());
+    int lineNumber = 0;
+    for (QByteArray line : bytes.split('\n')) {
+        ++lineNumber;
+        line = line.trimmed();
+        if (line.isEmpty() || line.startsWith('#') || line.startsWith("version,")) {
+            continue;
+        }
+        
+        const QList<QByteArray> fields = splitCsvLine(line);
+        if (fields.size() != 5) {
+            qWarning() << "Ignoring season override on line" << lineNumber << "with" << fields.size()
+                       << "fields, expected 5 (quote fields that contain commas)";
+            continue;
+        }
+        bool versionOk = false;
+        bool numberOk = false;
+        const int version = fields[0].toInt(&versionOk);
+        const int number = fields[1].toInt(&numberOk);
+        if (!versionOk || !numberOk) {
+            qWarning() << "Ignoring malformed season override on line" << lineNumber;
+            continue;
+        }
+        if (findVersion(version)) {
+            qDebug() << "Season override for v" << version << "is already built in, ignoring it";
+            continue;
+        }
+        
+        m_overrides.insert(version, makeSeasonInfo(version,
+                                                   QString::fromUtf8(fields[4]),
+                                                   number,
+                                                   QString::fromUtf8(fields[3]),
+                                                   QString::fromUtf8(fields[2])));
+    }
+    
+    file.unmap(mapped);
+    qDebug() << "Loaded" << m_overrides.size() << "season overrides from" << file.fileName();
+}
@@ -0,0 +1,68 @@
+#include "startupprofiler.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QDebug>
+
+QElapsedTimer StartupProfiler::s_clock;
+QVector<StartupProfiler::Phase> StartupProfiler::s_phases;
+qint64 StartupProfiler::s_lastMark = 0;
+bool StartupProfiler::s_traceEnabled = false;
+
+void StartupProfiler::start(bool traceEnabled)
+{
+    s_clock.start();
+    s_traceEnabled = traceEnabled;
+    s_lastMark = 0;
+    s_phases.clear();
+}
+
+void StartupProfiler::mark(const QString &phase)
+{
+    const qint64 now = s_clock.nsecsElapsed() / 1000;
+    s_phases.append({phase, s_lastMark, now});
+    s_lastMark = now;
+    if (s_traceEnabled) {
+        qDebug().noquote() << QString("Startup: %1 took %2 ms (at %3 ms)")
+                                  .arg(phase).arg((now - s_phases.last().start) / 1000.0, 0, 'f', 1)
+                                  .arg(now / 1000.0, 0, 'f', 1);
+    }
+}
+
+void StartupProfiler::finish()
+{
+    if (!s_traceEnabled || s_phases.isEmpty()) {
+        return;
+    }
+    
+    QJsonArray events;
+    for (const Phase &phase : s_phases) {
+        QJsonObject event;
+        event["name"] = phase.name;
+        event["cat"] = "startup";
+        event["ph"] = "X";
+        event["ts"] = double(phase.start);
+        event["dur"] = double(phase.end - phase.start);
+        event["pid"] = 1;
+        event["tid"] = 1;
+        events.append(event);
+    }
+    QJsonObject trace;
+    trace["traceEvents"] = events;
+    trace["displayTimeUnit"] = "ms";
+    
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    QSaveFile file(dir + "/startup-trace.json");
+    if (!file.open(QIODevice::WriteOnly)
+        || file.write(QJsonDocument(trace).toJson(QJsonDocument::Compact)) < 0
+        || !file.commit()) {
+        qWarning() << "Failed to write startup trace:" << file.errorString();
+        return;
+    }
+    qDebug() << "Wrote startup trace to" << file.fileName();
+}
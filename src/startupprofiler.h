@@ -0,0 +1,34 @@
+#ifndef STARTUPPROFILER_H
+#define STARTUPPROFILER_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QVector>
+
+// Startup timeline from the top of main(). Each mark() closes the phase that began at the previous
+// mark. With --startup-trace (or GODROLL_STARTUP_TRACE) the phases are written as a Chrome trace
+// to startup-trace.json in the app data folder; otherwise only the milestones are logged.
+class StartupProfiler
+{
+public:
+    static void start(bool traceEnabled);
+    static void mark(const QString &phase);
+    static qint64 elapsed() { return s_clock.elapsed(); }
+
+    // Writes the trace (when enabled) after the last phase
+    static void finish();
+
+private:
+    struct Phase {
+        QString name;
+        qint64 start;  // Microseconds since start()
+        qint64 end;
+    };
+
+    static QElapsedTimer s_clock;
+    static QVector<Phase> s_phases;
+    static qint64 s_lastMark;
+    static bool s_traceEnabled;
+};
+
+#endif // STARTUPPROFILER_H
@@ -16,7 +16,10 @@
 TrayIcon::TrayIcon(QObject *parent)
     : QObject(parent)
     , m_trayIcon(new QSystemTrayIcon(this))
-    , m_menu(new QMenu())
+    , m_menu(nullptr)
+    , m_startupAction(nullptr)
+    , m_checkUpdatesAction(nullptr)
+    , m_exitAction(nullptr)
 {
     // Set icon - use the app logo
     QIcon appIcon(":/qt/qml/GodrollLauncher/resources/logo.svg");
@@ -40,6 +43,22 @@ TrayIcon::TrayIcon(QObject *parent)
     QString version = QCoreApplication::applicationVersion();
     m_trayIcon->setToolTip(QString("Godroll.tv Launcher v%1").arg(version));
 
+    // Connect tray icon activation
+    connect(m_trayIcon, &QSystemTrayIcon::activated, this, &TrayIcon::onActivated);
+}
+
+TrayIcon::~TrayIcon()
+{
+    delete m_menu;
+}
+
+void TrayIcon::finishSetup()
+{
+    if (m_menu) {
+        return;
+    }
+    QString version = QCoreApplication::applicationVersion();
+
     // Auto-register startup on first run, or update path if already registered
     initializeStartup();
 
@@ -63,6 +82,7 @@ TrayIcon::TrayIcon(QObject *parent)
     connect(m_exitAction, &QAction::triggered, this, &TrayIcon::exitRequested);
 
     // Build menu
+    m_menu = new QMenu();
     m_menu->addAction(titleAction);
     m_menu->addSeparator();
     m_menu->addAction(m_startupAction);
@@ -71,14 +91,6 @@ TrayIcon::TrayIcon(QObject *parent)
     m_menu->addAction(m_exitAction);
 
     m_trayIcon->setContextMenu(m_menu);
-
-    // Connect tray icon activation
-    connect(m_trayIcon, &QSystemTrayIcon::activated, this, &TrayIcon::onActivated);
-}
-
-TrayIcon::~TrayIcon()
-{
-    delete m_menu;
 }
 
 void TrayIcon::show()
@@ -17,6 +17,10 @@ public:
     void show();
     void hide();
 
+    // Builds the context menu and refreshes the login item. Not needed for the first search,
+    // so main() runs it after startup; the icon itself shows without it.
+    void finishSetup();
+
 signals:
     void showHideRequested();
     void exitRequested();
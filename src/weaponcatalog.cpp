@@ -0,0 +1,521 @@
+#include "weaponcatalog.h"
+#include <QAtomicInt>
+#include <QJsonObject>
+#include <QHash>
+#include <QSet>
+#include <algorithm>
+
+// Split text into lowercase words (letters and digits only), e.g. "Fatebringer (Timelost)" -> fatebringer, timelost
+static void collectWords(const QString &text, QSet<QString> &words)
+{
+    QString word;
+    for (const QChar &ch : text) {
+        if (ch.isLetterOrNumber()) {
+            word.append(ch.toLower());
+        } else if (!word.isEmpty()) {
+            if (word.length() > 1) {
+                words.insert(word);
+            }
+            word.clear();
+        }
+    }
+    if (word.length() > 1) {
+        words.insert(word);
+    }
+}
+
+// Helper: Get base weapon name by removing parenthetical suffixes like (Adept), (Harrowed), (Timelost)
+static QString getBaseWeaponName(const QString &name)
+{
+    // Remove any parenthetical suffix: "Nullify (Adept)" -> "Nullify"
+    QString baseName = name;
+    int parenIndex = baseName.indexOf('(');
+    if (parenIndex > 0) {
+        baseName = baseName.left(parenIndex).trimmed();
+    }
+    return baseName.toLower();
+}
+
+// Helper: Check if weapon has a special suffix (Adept, Harrowed, Timelost, etc.)
+// This checks both the API field and the weapon name
+static bool isAdeptWeapon(const QJsonObject &weapon)
+{
+    // Check API's isAdept field first
+    if (weapon["isAdept"].toBool()) {
+        return true;
+    }
+
+    // Also check weapon name for (Adept), (Harrowed), (Timelost) suffixes
+    // This covers cases where API field might not be set for all variants
+    QString nameLower = weapon["name"].toString().toLower();
+    return nameLower.contains("(adept)") ||
+           nameLower.contains("(harrowed)") ||
+           nameLower.contains("(timelost)");
+}
+
+// One shared copy per distinct string: thousands of weapons share the same type, frame,
+// season and icon paths, and interning lets them all point at a single buffer
+static QString intern(QSet<QString> &pool, const QString &text)
+{
+    auto it = pool.constFind(text);
+    if (it != pool.cend()) {
+        return *it;
+    }
+    pool.insert(text);
+    return text;
+}
+
+// Vocabulary words of one weapon, each counted once per weapon
+static QSet<QString> weaponWords(const WeaponRecord &weapon)
+{
+    QSet<QString> words;
+    collectWords(weapon.name, words);
+    collectWords(weapon.weaponType, words);
+    collectWords(weapon.frameType, words);
+    collectWords(weapon.seasonName, words);
+    return words;
+}
+
+// Identity of a weapon across API refreshes; repeated hashes are told apart by occurrence
+static QString weaponKey(const WeaponRecord &weapon, QHash<QString, int> &occurrences)
+{
+    const int occurrence = occurrences[weapon.hash]++;
+    return occurrence == 0 ? weapon.hash : weapon.hash + '#' + QString::number(occurrence);
+}
+
+static QDataStream &operator<<(QDataStream &out, const WeaponRecord &weapon)
+{
+    return out << weapon.hash << weapon.name << weapon.icon << weapon.weaponType << weapon.frameType
+               << weapon.seasonName << weapon.season << weapon.seasonDisplay << weapon.damageType
+               << weapon.damageTypeIcon << weapon.ammoType << weapon.ammoTypeIcon
+               << weapon.sourceDisplayName << weapon.sourceSearchAliases << qint32(weapon.seasonNumber)
+               << weapon.isHolofoil << weapon.isExotic << weapon.isAdept;
+}
+
+static void readRecord(QDataStream &in, WeaponRecord &weapon, QSet<QString> &pool)
+{
+    qint32 seasonNumber = 0;
+    in >> weapon.hash >> weapon.name >> weapon.icon >> weapon.weaponType >> weapon.frameType
+       >> weapon.seasonName >> weapon.season >> weapon.seasonDisplay >> weapon.damageType
+       >> weapon.damageTypeIcon >> weapon.ammoType >> weapon.ammoTypeIcon
+       >> weapon.sourceDisplayName >> weapon.sourceSearchAliases >> seasonNumber
+       >> weapon.isHolofoil >> weapon.isExotic >> weapon.isAdept;
+    weapon.seasonNumber = seasonNumber;
+
+    for (QString *text : {&weapon.icon, &weapon.weaponType, &weapon.frameType, &weapon.seasonName,
+                          &weapon.season, &weapon.seasonDisplay, &weapon.damageType, &weapon.damageTypeIcon,
+                          &weapon.ammoType, &weapon.ammoTypeIcon, &weapon.sourceDisplayName}) {
+        *text = intern(pool, *text);
+    }
+    for (QString &alias : weapon.sourceSearchAliases) {
+        alias = intern(pool, alias);
+    }
+}
+
+bool WeaponRecord::operator==(const WeaponRecord &other) const
+{
+    return hash == other.hash && name == other.name && icon == other.icon
+        && weaponType == other.weaponType && frameType == other.frameType
+        && seasonName == other.seasonName && season == other.season && seasonDisplay == other.seasonDisplay
+        && damageType == other.damageType && damageTypeIcon == other.damageTypeIcon
+        && ammoType == other.ammoType && ammoTypeIcon == other.ammoTypeIcon
+        && sourceDisplayName == other.sourceDisplayName && sourceSearchAliases == other.sourceSearchAliases
+        && seasonNumber == other.seasonNumber
+        && isHolofoil == other.isHolofoil && isExotic == other.isExotic && isAdept == other.isAdept;
+}
+
+static QAtomicInt nextCatalogSerial;
+
+// Reserve for a count read from a stream, never more than the remaining bytes could hold,
+// so a corrupt count fails on the first missing element instead of allocating gigabytes
+static qsizetype boundedReserve(QDataStream &in, quint32 count)
+{
+    const qint64 available = in.device() ? in.device()->bytesAvailable() : 0;
+    return qsizetype(qMin<qint64>(count, available / qint64(sizeof(quint32))));
+}
+
+QVector<WeaponRecord> WeaponCatalog::project(const QJsonArray &weapons)
+{
+    QSet<QString> pool;
+    QVector<WeaponRecord> records;
+    records.reserve(weapons.size());
+
+    for (const QJsonValue &value : weapons) {
+        QJsonObject weapon = value.toObject();
+
+        WeaponRecord record;
+        record.hash = weapon["hash"].toVariant().toString();
+        record.name = weapon["name"].toString();
+        record.icon = weapon["icon"].toString();
+        record.weaponType = intern(pool, weapon["weaponType"].toString());
+        record.frameType = intern(pool, weapon["frameType"].toString());
+        record.seasonName = intern(pool, weapon["seasonName"].toString());
+        record.season = intern(pool, weapon["season"].toString());
+        record.seasonDisplay = intern(pool, weapon["seasonDisplay"].toString());
+        record.damageType = intern(pool, weapon["damageType"].toString());
+        record.damageTypeIcon = intern(pool, weapon["damageTypeIcon"].toString());
+        record.ammoType = intern(pool, weapon["ammoType"].toString());
+        record.ammoTypeIcon = intern(pool, weapon["ammoTypeIcon"].toString());
+        record.sourceDisplayName = intern(pool, weapon["sourceDisplayName"].toString());
+        for (const QJsonValue &alias : weapon["sourceSearchAliases"].toArray()) {
+            record.sourceSearchAliases.append(intern(pool, alias.toString().toLower()));
+        }
+        record.seasonNumber = weapon["seasonNumber"].toInt();
+        record.isHolofoil = weapon["isHolofoil"].toBool();
+        record.isExotic = weapon["isExotic"].toBool();
+        record.isAdept = isAdeptWeapon(weapon);
+        records.append(record);
+    }
+
+    return records;
+}
+
+WeaponCatalogPtr WeaponCatalog::build(const QJsonArray &weapons)
+{
+    return build(project(weapons));
+}
+
+WeaponCatalogPtr WeaponCatalog::build(const QVector<WeaponRecord> &weapons)
+{
+    QSharedPointer<WeaponCatalog> catalog(new WeaponCatalog);
+    catalog->m_serial = nextCatalogSerial.fetchAndAddRelaxed(1) + 1;
+    catalog->m_weapons = weapons;
+    catalog->m_searchFields.resize(weapons.size());
+    catalog->m_holofoil.resize(weapons.size());
+    catalog->m_exotic.resize(weapons.size());
+    catalog->m_adept.resize(weapons.size());
+
+    QSet<QString> pool;
+    QHash<QString, int> wordWeights;
+    for (int i = 0; i < weapons.size(); ++i) {
+        catalog->indexWeapon(i, pool);
+        for (const QString &word : weaponWords(weapons[i])) {
+            wordWeights[word]++;
+        }
+    }
+
+    catalog->finishIndex(wordWeights);
+    return catalog;
+}
+
+WeaponCatalogPtr WeaponCatalog::update(const WeaponCatalogPtr &base, const QJsonArray &json)
+{
+    if (!base) {
+        return build(json);
+    }
+
+    const QVector<WeaponRecord> weapons = project(json);
+
+    QSharedPointer<WeaponCatalog> catalog(new WeaponCatalog);
+    catalog->m_serial = nextCatalogSerial.fetchAndAddRelaxed(1) + 1;
+    catalog->m_weapons = weapons;
+    catalog->m_searchFields.resize(weapons.size());
+    catalog->m_holofoil.resize(weapons.size());
+    catalog->m_exotic.resize(weapons.size());
+    catalog->m_adept.resize(weapons.size());
+
+    Delta &delta = catalog->m_delta;
+    delta.baseSerial = base->m_serial;
+    delta.baseToNew.fill(-1, base->size());
+
+    QHash<QString, int> baseByKey;
+    QHash<QString, int> occurrences;
+    for (int j = 0; j < base->size(); ++j) {
+        baseByKey.insert(weaponKey(base->m_weapons[j], occurrences), j);
+    }
+
+    // Start from the old word weights and only patch in the weapons that differ
+    QHash<QString, int> wordWeights;
+    wordWeights.reserve(base->m_vocabulary.size());
+    for (const VocabularyEntry &entry : base->m_vocabulary) {
+        wordWeights.insert(entry.word, entry.weight);
+    }
+
+    QSet<QString> pool;
+    QBitArray matched(base->size());
+    occurrences.clear();
+    for (int i = 0; i < weapons.size(); ++i) {
+        const WeaponRecord &weapon = weapons[i];
+        const int j = baseByKey.value(weaponKey(weapon, occurrences), -1);
+        if (j >= 0) {
+            matched.setBit(j);
+        }
+
+        if (j >= 0 && base->m_weapons[j] == weapon) {
+            // Unchanged: reuse the old record (and its shared strings) and everything derived from it
+            catalog->m_weapons[i] = base->m_weapons[j];
+            catalog->m_searchFields[i] = base->m_searchFields[j];
+            catalog->m_holofoil.setBit(i, base->m_holofoil.testBit(j));
+            catalog->m_exotic.setBit(i, base->m_exotic.testBit(j));
+            catalog->m_adept.setBit(i, base->m_adept.testBit(j));
+            delta.baseToNew[j] = i;
+            continue;
+        }
+
+        if (j >= 0) {
+            for (const QString &word : weaponWords(base->m_weapons[j])) {
+                wordWeights[word]--;
+            }
+            delta.changed.append(i);
+        } else {
+            delta.added.append(i);
+        }
+        catalog->indexWeapon(i, pool);
+        for (const QString &word : weaponWords(weapon)) {
+            wordWeights[word]++;
+        }
+    }
+
+    for (int j = 0; j < base->size(); ++j) {
+        if (!matched.testBit(j)) {
+            for (const QString &word : weaponWords(base->m_weapons[j])) {
+                wordWeights[word]--;
+            }
+            delta.removed.append(j);
+        }
+    }
+
+    catalog->finishIndex(wordWeights);
+    return catalog;
+}
+
+void WeaponCatalog::indexWeapon(int i, QSet<QString> &pool)
+{
+    const WeaponRecord &weapon = m_weapons[i];
+
+    SearchFields &fields = m_searchFields[i];
+    fields.name = weapon.name;
+    fields.nameLower = fields.name.toLower();
+    fields.baseName = getBaseWeaponName(fields.name);
+    fields.weaponType = intern(pool, weapon.weaponType.toLower());
+    fields.frameType = intern(pool, weapon.frameType.toLower());
+    fields.seasonName = intern(pool, weapon.seasonName.toLower());
+    fields.season = intern(pool, weapon.season.toLower());
+    fields.seasonDisplay = intern(pool, weapon.seasonDisplay.toLower());
+    fields.seasonNumber = intern(pool, QString::number(weapon.seasonNumber));
+    fields.seasonNum = weapon.seasonNumber;
+
+    m_holofoil.setBit(i, weapon.isHolofoil);
+    m_exotic.setBit(i, weapon.isExotic);
+    m_adept.setBit(i, weapon.isAdept);
+}
+
+void WeaponCatalog::finishIndex(const QHash<QString, int> &wordWeights)
+{
+    // Find latest season number
+    for (const SearchFields &fields : m_searchFields) {
+        if (fields.seasonNum > m_latestSeason) {
+            m_latestSeason = fields.seasonNum;
+        }
+    }
+
+    // Collation keys: sort once here so result ordering never compares strings
+    // (ranks shift whenever a name is added, so they are always recomputed)
+    QVector<int> byName(m_searchFields.size());
+    for (int i = 0; i < byName.size(); ++i) {
+        byName[i] = i;
+    }
+    const QVector<SearchFields> &fields = m_searchFields;
+    std::sort(byName.begin(), byName.end(),
+              [&fields](int a, int b) { return fields[a].nameLower < fields[b].nameLower; });
+    m_nameRanks.resize(m_searchFields.size());
+    int rank = 0;
+    for (int i = 0; i < byName.size(); ++i) {
+        if (i > 0 && fields[byName[i]].nameLower != fields[byName[i - 1]].nameLower) {
+            rank++;
+        }
+        m_nameRanks[byName[i]] = rank;
+    }
+
+    m_vocabulary.reserve(wordWeights.size());
+    for (auto it = wordWeights.cbegin(); it != wordWeights.cend(); ++it) {
+        if (it.value() > 0) {
+            m_vocabulary.append({it.key(), it.value()});
+        }
+    }
+    std::sort(m_vocabulary.begin(), m_vocabulary.end(),
+              [](const VocabularyEntry &a, const VocabularyEntry &b) { return a.word < b.word; });
+}
+
+void WeaponCatalog::writeTo(QDataStream &out) const
+{
+    // Records and the derived index as plain fields
+    out << quint32(m_weapons.size());
+    for (const WeaponRecord &weapon : m_weapons) {
+        out << weapon;
+    }
+    out << qint32(m_latestSeason);
+
+    out << quint32(m_searchFields.size());
+    for (const SearchFields &fields : m_searchFields) {
+        out << fields.name << fields.nameLower << fields.baseName << fields.weaponType << fields.frameType
+            << fields.seasonName << fields.season << fields.seasonDisplay << fields.seasonNumber
+            << qint32(fields.seasonNum);
+    }
+
+    // One name rank and flag byte per weapon: the length follows from the weapon list, so no count is stored
+    for (int i = 0; i < m_weapons.size(); ++i) {
+        out << qint32(m_nameRanks[i])
+            << quint8((m_holofoil.testBit(i) ? 1 : 0) | (m_exotic.testBit(i) ? 2 : 0) | (m_adept.testBit(i) ? 4 : 0));
+    }
+
+    out << quint32(m_vocabulary.size());
+    for (const VocabularyEntry &entry : m_vocabulary) {
+        out << entry.word << qint32(entry.weight);
+    }
+}
+
+WeaponCatalogPtr WeaponCatalog::readFrom(QDataStream &in)
+{
+    QSharedPointer<WeaponCatalog> catalog(new WeaponCatalog);
+    catalog->m_serial = nextCatalogSerial.fetchAndAddRelaxed(1) + 1;
+
+    // Strings come back as separate copies, intern them again like build() does
+    QSet<QString> pool;
+
+    quint32 weaponCount = 0;
+    in >> weaponCount;
+    if (in.status() != QDataStream::Ok) {
+        return WeaponCatalogPtr();
+    }
+    catalog->m_weapons.reserve(boundedReserve(in, weaponCount));
+    for (quint32 i = 0; i < weaponCount && in.status() == QDataStream::Ok; ++i) {
+        WeaponRecord weapon;
+        readRecord(in, weapon, pool);
+        catalog->m_weapons.append(weapon);
+    }
+
+    qint32 latestSeason = 0;
+    in >> latestSeason;
+    catalog->m_latestSeason = latestSeason;
+
+    quint32 fieldCount = 0;
+    in >> fieldCount;
+    if (in.status() != QDataStream::Ok || fieldCount != quint32(catalog->m_weapons.size())) {
+        return WeaponCatalogPtr();
+    }
+    catalog->m_searchFields.resize(fieldCount);
+    for (int i = 0; i < catalog->m_searchFields.size(); ++i) {
+        SearchFields &fields = catalog->m_searchFields[i];
+        qint32 seasonNum = 0;
+        in >> fields.name >> fields.nameLower >> fields.baseName >> fields.weaponType >> fields.frameType
+           >> fields.seasonName >> fields.season >> fields.seasonDisplay >> fields.seasonNumber
+           >> seasonNum;
+        fields.seasonNum = seasonNum;
+        fields.name = catalog->m_weapons[i].name;
+        for (QString *text : {&fields.weaponType, &fields.frameType, &fields.seasonName,
+                              &fields.season, &fields.seasonDisplay, &fields.seasonNumber}) {
+            *text = intern(pool, *text);
+        }
+    }
+
+    // Sized from the weapons already read, never from a count in the stream
+    const int count = catalog->m_weapons.size();
+    catalog->m_nameRanks.resize(count);
+    catalog->m_holofoil.resize(count);
+    catalog->m_exotic.resize(count);
+    catalog->m_adept.resize(count);
+    for (int i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        qint32 nameRank = 0;
+        quint8 flags = 0;
+        in >> nameRank >> flags;
+        catalog->m_nameRanks[i] = nameRank;
+        catalog->m_holofoil.setBit(i, flags & 1);
+        catalog->m_exotic.setBit(i, flags & 2);
+        catalog->m_adept.setBit(i, flags & 4);
+    }
+
+    quint32 vocabularyCount = 0;
+    in >> vocabularyCount;
+    if (in.status() != QDataStream::Ok) {
+        return WeaponCatalogPtr();
+    }
+    catalog->m_vocabulary.reserve(boundedReserve(in, vocabularyCount));
+    for (quint32 i = 0; i < vocabularyCount && in.status() == QDataStream::Ok; ++i) {
+        VocabularyEntry entry;
+        qint32 weight = 0;
+        in >> entry.word >> weight;
+        entry.weight = weight;
+        catalog->m_vocabulary.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        return WeaponCatalogPtr();
+    }
+
+    return catalog;
+}
+
+qint64 WeaponCatalog::stringBytes(const QString &text, QSet<const void *> &seen)
+{
+    if (text.isEmpty() || seen.contains(text.constData())) {
+        return 0;
+    }
+    seen.insert(text.constData());
+    // Payload plus the ref-counted array header
+    return qint64(text.capacity() + 1) * qint64(sizeof(QChar)) + 16;
+}
+
+WeaponCatalog::MemoryUsage WeaponCatalog::memoryUsage() const
+{
+    MemoryUsage usage;
+    QSet<const void *> seen;
+
+    usage.records = qint64(m_weapons.capacity()) * qint64(sizeof(WeaponRecord));
+    for (const WeaponRecord &weapon : m_weapons) {
+        for (const QString *text : {&weapon.hash, &weapon.name, &weapon.icon, &weapon.weaponType,
+                                    &weapon.frameType, &weapon.seasonName, &weapon.season, &weapon.seasonDisplay,
+                                    &weapon.damageType, &weapon.damageTypeIcon, &weapon.ammoType,
+                                    &weapon.ammoTypeIcon, &weapon.sourceDisplayName}) {
+            usage.records += stringBytes(*text, seen);
+        }
+        usage.records += qint64(weapon.sourceSearchAliases.capacity()) * qint64(sizeof(QString));
+        for (const QString &alias : weapon.sourceSearchAliases) {
+            usage.records += stringBytes(alias, seen);
+        }
+    }
+
+    usage.index = qint64(m_searchFields.capacity()) * qint64(sizeof(SearchFields));
+    for (const SearchFields &fields : m_searchFields) {
+        for (const QString *text : {&fields.name, &fields.nameLower, &fields.baseName, &fields.weaponType,
+                                    &fields.frameType, &fields.seasonName, &fields.season, &fields.seasonDisplay,
+                                    &fields.seasonNumber}) {
+            usage.index += stringBytes(*text, seen);
+        }
+    }
+    usage.index += qint64(m_nameRanks.capacity()) * qint64(sizeof(int));
+    usage.index += (m_holofoil.size() + m_exotic.size() + m_adept.size()) / 8;
+    usage.index += qint64(m_vocabulary.capacity()) * qint64(sizeof(VocabularyEntry));
+    for (const VocabularyEntry &entry : m_vocabulary) {
+        usage.index += stringBytes(entry.word, seen);
+    }
+
+    return usage;
+}
+
+QString WeaponCatalog::likelyNextChars(const QString &prefix, int maxChars) const
+{
+    // Vocabulary is sorted, so all words starting with prefix form one contiguous range
+    auto it = std::lower_bound(m_vocabulary.cbegin(), m_vocabulary.cend(), prefix,
+                               [](const VocabularyEntry &entry, const QString &value) { return entry.word < value; });
+
+    QHash<QChar, int> charWeights;
+    for (; it != m_vocabulary.cend() && it->word.startsWith(prefix); ++it) {
+        if (it->word.length() > prefix.length()) {
+            charWeights[it->word[prefix.length()]] += it->weight;
+        }
+    }
+
+    QList<QPair<int, QChar>> ranked;
+    for (auto weight = charWeights.cbegin(); weight != charWeights.cend(); ++weight) {
+        ranked.append({weight.value(), weight.key()});
+    }
+    std::sort(ranked.begin(), ranked.end(),
+              [](const auto &a, const auto &b) { return a.first > b.first; });
+
+    QString chars;
+    for (int i = 0; i < ranked.size() && i < maxChars; ++i) {
+        chars.append(ranked[i].second);
+    }
+    return chars;
+}
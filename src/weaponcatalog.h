@@ -0,0 +1,138 @@
+#ifndef WEAPONCATALOG_H
+#define WEAPONCATALOG_H
+
+#include <QJsonArray>
+#include <QBitArray>
+#include <QDataStream>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// The fields of an API weapon the launcher actually uses. Everything else the endpoint
+// returns (traitIds, tier info, ...) is dropped when the catalog is built.
+struct WeaponRecord {
+    QString hash;
+    QString name;
+    QString icon;
+    QString weaponType;
+    QString frameType;
+    QString seasonName;
+    QString season;
+    QString seasonDisplay;
+    QString damageType;
+    QString damageTypeIcon;
+    QString ammoType;
+    QString ammoTypeIcon;
+    QString sourceDisplayName;
+    QStringList sourceSearchAliases;  // Lowercased
+    int seasonNumber = 0;
+    bool isHolofoil = false;
+    bool isExotic = false;
+    bool isAdept = false;             // API flag or (Adept)/(Harrowed)/(Timelost) name suffix
+
+    bool operator==(const WeaponRecord &other) const;
+};
+
+// Immutable snapshot of the loaded weapon list plus data derived from it.
+// Shared (read-only) between the GUI thread and background search workers.
+class WeaponCatalog
+{
+public:
+    // Per-weapon text fields prepared once per catalog instead of once per query
+    struct SearchFields {
+        QString name;           // Original name (scored for highlighting, shown in the UI)
+        QString nameLower;
+        QString baseName;       // Lowercased name without (Adept), (Harrowed), ... suffix
+        QString weaponType;     // Remaining fields are lowercased
+        QString frameType;
+        QString seasonName;
+        QString season;         // "season x" format
+        QString seasonDisplay;  // Full display name
+        QString seasonNumber;   // Season number as text for exact "28"/"s28" matches
+        int seasonNum;
+    };
+
+    struct VocabularyEntry {
+        QString word;   // Lowercase word from name, type, frame or season fields
+        int weight;     // Number of weapons containing the word
+    };
+
+    // Approximate heap bytes; strings shared through interning are counted once
+    struct MemoryUsage {
+        qint64 records = 0;  // WeaponRecord list and its strings
+        qint64 index = 0;    // Search fields, name ranks, attribute bitmaps, vocabulary
+    };
+
+    // Difference to the catalog this one was updated from (see update())
+    struct Delta {
+        int baseSerial = 0;      // serial() of the base catalog, 0 when built from scratch
+        QVector<int> added;      // Indices in this catalog
+        QVector<int> changed;    // Indices in this catalog
+        QVector<int> removed;    // Indices in the base catalog
+        QVector<int> baseToNew;  // Base index -> index in this catalog, -1 when removed or changed
+    };
+
+    static QSharedPointer<const WeaponCatalog> build(const QJsonArray &weapons);
+    static QSharedPointer<const WeaponCatalog> build(const QVector<WeaponRecord> &weapons);
+
+    // Like build(), but weapons whose record is identical to their counterpart in base (matched
+    // by hash) reuse its derived data, and the vocabulary is patched instead of recounted
+    static QSharedPointer<const WeaponCatalog> update(const QSharedPointer<const WeaponCatalog> &base,
+                                                      const QJsonArray &weapons);
+
+    // Binary form of the catalog including everything build() derives, so a restored
+    // catalog is searchable without re-indexing. readFrom() returns null on malformed data.
+    void writeTo(QDataStream &out) const;
+    static QSharedPointer<const WeaponCatalog> readFrom(QDataStream &in);
+
+    const QVector<WeaponRecord> &weapons() const { return m_weapons; }
+    const WeaponRecord &weapon(int index) const { return m_weapons[index]; }
+    int serial() const { return m_serial; }  // Unique per catalog instance
+    const Delta &delta() const { return m_delta; }
+    int size() const { return m_weapons.size(); }
+    int latestSeason() const { return m_latestSeason; }
+    const SearchFields &searchFields(int index) const { return m_searchFields[index]; }
+
+    // Position of the weapon in a case-folded alphabetical order of all names (equal names share a rank)
+    int nameRank(int index) const { return m_nameRanks[index]; }
+
+    // Attribute bitmaps for the -h/-e/-a filters
+    bool isHolofoil(int index) const { return m_holofoil.testBit(index); }
+    bool isExotic(int index) const { return m_exotic.testBit(index); }
+    bool isAdept(int index) const { return m_adept.testBit(index); }
+
+    const QVector<VocabularyEntry> &vocabulary() const { return m_vocabulary; }  // Sorted by word
+
+    // Characters that most often follow prefix in vocabulary words, most likely first
+    QString likelyNextChars(const QString &prefix, int maxChars) const;
+
+    MemoryUsage memoryUsage() const;
+
+    // Heap bytes of text unless its buffer is already in seen (shared copies count once)
+    static qint64 stringBytes(const QString &text, QSet<const void *> &seen);
+
+private:
+    WeaponCatalog() = default;
+
+    static QVector<WeaponRecord> project(const QJsonArray &weapons);
+    void indexWeapon(int i, QSet<QString> &pool);
+    void finishIndex(const QHash<QString, int> &wordWeights);
+
+    int m_serial = 0;
+    Delta m_delta;
+    QVector<WeaponRecord> m_weapons;
+    int m_latestSeason = 0;
+    QVector<SearchFields> m_searchFields;
+    QVector<int> m_nameRanks;
+    QBitArray m_holofoil;
+    QBitArray m_exotic;
+    QBitArray m_adept;
+    QVector<VocabularyEntry> m_vocabulary;
+};
+
+using WeaponCatalogPtr = QSharedPointer<const WeaponCatalog>;
+
+#endif // WEAPONCATALOG_H
@@ -2,13 +2,31 @@
 #include "seasonmapping.h"
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtConcurrent>
 #include <QDebug>
 
+const QString WeaponLoader::DEFAULT_API_URL = "https://godroll.tv/api/weapons/list";
+
 WeaponLoader::WeaponLoader(QObject *parent)
     : QObject(parent)
     , m_networkManager(new QNetworkAccessManager(this))
+    , m_endpoint(qEnvironmentVariableIsSet("GODROLL_API_URL")
+                 ? QUrl(qEnvironmentVariable("GODROLL_API_URL"))
+                 : QUrl(DEFAULT_API_URL))
     , m_currentReply(nullptr)
     , m_timeoutTimer(new QTimer(this))
+    , m_retryTimer(new QTimer(this))
+    , m_refreshTimer(new QTimer(this))
+    , m_processingWatcher(new QFutureWatcher<ProcessedResponse>(this))
     , m_retryCount(0)
 {
     connect(m_networkManager, &QNetworkAccessManager::finished,
@@ -17,31 +35,222 @@ WeaponLoader::WeaponLoader(QObject *parent)
     // Setup timeout timer
     m_timeoutTimer->setSingleShot(true);
     connect(m_timeoutTimer, &QTimer::timeout, this, &WeaponLoader::onTimeout);
+    
+    // Setup retry timer
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &WeaponLoader::onRetryTimer);
+    
+    // Setup periodic refresh timer
+    QSettings settings("Godroll.tv", "GodrollLauncher");
+    m_refreshIntervalMinutes = qBound(0, settings.value("refreshIntervalMinutes", DEFAULT_REFRESH_MINUTES).toInt(),
+                                      MAX_REFRESH_MINUTES);
+    connect(m_refreshTimer, &QTimer::timeout, this, &WeaponLoader::onRefreshTimer);
+    if (m_refreshIntervalMinutes > 0) {
+        m_refreshTimer->start(m_refreshIntervalMinutes * 60 * 1000);
+    }
+    
+    connect(m_processingWatcher, &QFutureWatcher<ProcessedResponse>::finished,
+            this, &WeaponLoader::onProcessingFinished);
 }
 
-void WeaponLoader::loadWeapons(std::function<void(const QJsonArray&)> callback)
+void WeaponLoader::loadWeapons(std::function<void(const WeaponCatalogPtr&)> callback)
 {
     m_callback = callback;
     m_retryCount = 0;
+    m_loadTimer.start();
+    
+    // Make the launcher searchable right away, the API refresh replaces it when it arrives
+    if (WeaponCatalogPtr snapshot = loadSnapshot()) {
+        setFreshness(QFileInfo(snapshotPath()).lastModified(), QString());
+        publishCatalog(snapshot);
+    }
     
     startRequest();
 }
 
+void WeaponLoader::setEndpoint(const QUrl &url)
+{
+    m_endpoint = url;
+    qDebug() << "Weapons endpoint:" << m_endpoint.toString();
+}
+
+void WeaponLoader::publishCatalog(const WeaponCatalogPtr &catalog)
+{
+    m_catalog = catalog;
+    
+    if (!m_searchableLogged && m_loadTimer.isValid()) {
+        m_searchableLogged = true;
+        qDebug() << "Searchable after" << m_loadTimer.elapsed() << "ms with" << catalog->size() << "weapons";
+    }
+    
+    // Emit signals for QML and C++ connections
+    emit weaponsLoaded();
+    emit catalogLoaded(catalog);
+    
+    if (m_callback) {
+        m_callback(catalog);
+    }
+}
+
+QString WeaponLoader::snapshotPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/catalog.bin";
+}
+
+// Snapshot layout: magic, version, payload size, SHA-1 of payload, payload
+// Payload (qCompress'ed): ETag, Last-Modified, response SHA-1, WeaponCatalog::writeTo
+WeaponCatalogPtr WeaponLoader::loadSnapshot()
+{
+    QElapsedTimer timer;
+    timer.start();
+    
+    QFile file(snapshotPath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return WeaponCatalogPtr();
+    }
+    
+    const qint64 headerSize = 4 + 4 + 8 + 20;
+    if (file.size() < headerSize) {
+        qWarning() << "Catalog snapshot is truncated, ignoring it";
+        return WeaponCatalogPtr();
+    }
+    
+    // A plain read: the payload is inflated into its own buffer anyway, so mapping would save nothing
+    const QByteArray bytes = file.readAll();
+    if (bytes.size() != file.size()) {
+        qWarning() << "Failed to read catalog snapshot:" << file.errorString();
+        return WeaponCatalogPtr();
+    }
+    
+    QDataStream header(bytes);
+    header.setVersion(QDataStream::Qt_6_0);
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint64 payloadSize = 0;
+    header >> magic >> version >> payloadSize;
+    
+    WeaponCatalogPtr catalog;
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        qDebug() << "Catalog snapshot has an old format, ignoring it";
+    } else if (payloadSize != quint64(bytes.size() - headerSize)) {
+        qWarning() << "Catalog snapshot size mismatch, ignoring it";
+    } else {
+        const QByteArray checksum = QByteArray::fromRawData(bytes.constData() + 16, 20);
+        const QByteArray payload = QByteArray::fromRawData(bytes.constData() + headerSize, payloadSize);
+        if (QCryptographicHash::hash(payload, QCryptographicHash::Sha1) != checksum) {
+            qWarning() << "Catalog snapshot checksum mismatch, ignoring it";
+        } else {
+            const QByteArray decompressed = qUncompress(payload);
+            QDataStream in(decompressed);
+            in.setVersion(QDataStream::Qt_6_0);
+            QByteArray etag;
+            QByteArray lastModified;
+            QByteArray payloadHash;
+            in >> etag >> lastModified >> payloadHash;
+            catalog = WeaponCatalog::readFrom(in);
+            if (!catalog) {
+                qWarning() << "Catalog snapshot is malformed, ignoring it";
+            } else {
+                m_etag = etag;
+                m_lastModified = lastModified;
+                m_payloadHash = payloadHash;
+            }
+        }
+    }
+    
+    if (catalog) {
+        qDebug() << "Restored" << catalog->size() << "weapons from snapshot in" << timer.elapsed() << "ms";
+    }
+    return catalog;
+}
+
+void WeaponLoader::saveSnapshot(const WeaponCatalogPtr &catalog, const QByteArray &etag, const QByteArray &lastModified,
+                                const QByteArray &payloadHash)
+{
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << etag << lastModified << payloadHash;
+    catalog->writeTo(out);
+    
+    // The index is mostly repeated lowercase text, fastest zlib level already shrinks it several times
+    const int rawSize = payload.size();
+    payload = qCompress(payload, SNAPSHOT_COMPRESSION_LEVEL);
+    qDebug() << "Catalog snapshot:" << rawSize << "bytes," << payload.size() << "compressed";
+    
+    QDir().mkpath(QFileInfo(snapshotPath()).absolutePath());
+    
+    // QSaveFile replaces the old snapshot only once the new one is completely written
+    QSaveFile file(snapshotPath());
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to write catalog snapshot:" << file.errorString();
+        return;
+    }
+    
+    QDataStream header(&file);
+    header.setVersion(QDataStream::Qt_6_0);
+    header << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << quint64(payload.size());
+    file.write(QCryptographicHash::hash(payload, QCryptographicHash::Sha1));
+    file.write(payload);
+    
+    if (!file.commit()) {
+        qWarning() << "Failed to write catalog snapshot:" << file.errorString();
+    }
+}
+
+void WeaponLoader::setFreshness(const QDateTime &lastUpdated, const QString &lastError)
+{
+    if (m_lastUpdated == lastUpdated && m_lastError == lastError) {
+        return;
+    }
+    m_lastUpdated = lastUpdated;
+    m_lastError = lastError;
+    emit freshnessChanged();
+}
+
 void WeaponLoader::startRequest()
 {
+    // The worker still owns the previous response (and writes its snapshot): a second one would
+    // replace the watcher's future and race it on catalog.bin, so go once it is published
+    if (m_processingWatcher->isRunning()) {
+        m_requestQueued = true;
+        return;
+    }
+    m_requestQueued = false;
+    
     // Cleanup any previous request
     cleanupCurrentRequest();
+    m_retryTimer->stop();
     
-    qDebug() << "Loading weapons from API..." << (m_retryCount > 0 ? QString("(retry %1/%2)").arg(m_retryCount).arg(MAX_RETRIES) : "");
+    qDebug() << "Loading weapons from API..." << (m_retryCount > 0 ? QString("(retry %1)").arg(m_retryCount) : "");
     
     // Load weapons from your API
-    QNetworkRequest request(QUrl("https://godroll.tv/api/weapons/list"));
+    QNetworkRequest request(m_endpoint);
     request.setHeader(QNetworkRequest::ContentTypeHeader, "application/json");
     
+    // Accept-Encoding is left to QNetworkAccessManager: it offers gzip/deflate (plus brotli and
+    // zstd when Qt is built with them) and inflates the body while it streams in. Setting the
+    // header ourselves would turn that off and hand us the compressed bytes.
+    
+    // Revalidate instead of downloading again when we already show this server's data
+    if (m_catalog) {
+        if (!m_etag.isEmpty()) {
+            request.setRawHeader("If-None-Match", m_etag);
+        }
+        if (!m_lastModified.isEmpty()) {
+            request.setRawHeader("If-Modified-Since", m_lastModified);
+        }
+    }
+    
+    // Scheduled refreshes yield to anything the user is waiting for
+    if (m_backgroundRequest) {
+        request.setPriority(QNetworkRequest::LowPriority);
+    }
+    
     m_currentReply = m_networkManager->get(request);
     
     // Start timeout timer
-    m_timeoutTimer->start(TIMEOUT_MS);
+    m_timeoutTimer->start(m_timeoutMs);
 }
 
 void WeaponLoader::cleanupCurrentRequest()
@@ -59,20 +268,35 @@ void WeaponLoader::cleanupCurrentRequest()
 
 void WeaponLoader::onTimeout()
 {
-    qWarning() << "Request timed out after" << (TIMEOUT_MS / 1000) << "seconds";
+    qWarning() << "Request timed out after" << m_timeoutMs << "ms";
+    cleanupCurrentRequest();
+    handleFailure(QString("Request timed out after %1 seconds").arg(m_timeoutMs / 1000.0, 0, 'g', 3));
+}
+
+// Keep whatever catalog is published and try again later: capped exponential backoff with
+// jitter, so a flaky connection recovers quickly and an outage doesn't hammer the API
+void WeaponLoader::handleFailure(const QString &error)
+{
+    m_retryCount++;
+    m_backgroundRequest = false;  // Retries are not scheduled refreshes
+    setFreshness(m_lastUpdated, error);
     
-    if (m_retryCount < MAX_RETRIES) {
-        m_retryCount++;
-        qDebug() << "Retrying... (" << m_retryCount << "/" << MAX_RETRIES << ")";
-        startRequest();
-    } else {
-        qWarning() << "Max retries reached. Failed to load weapons.";
-        cleanupCurrentRequest();
-        // Return empty array on failure
-        if (m_callback) {
-            m_callback(QJsonArray());
-        }
+    if (m_retryCount == MAX_RETRIES) {
+        qWarning() << "Max retries reached. Failed to load weapons:" << error;
+        emit loadFailed(error);
     }
+    
+    const int shift = qMin(m_retryCount - 1, 16);
+    const int backoff = static_cast<int>(qMin<qint64>(qint64(m_retryBaseMs) << shift, RETRY_MAX_MS));
+    // Equal jitter: half fixed, half random, so clients that failed together spread out
+    const int delay = backoff / 2 + QRandomGenerator::global()->bounded(backoff / 2 + 1);
+    qDebug() << "Retrying in" << delay << "ms (attempt" << m_retryCount << ")";
+    m_retryTimer->start(delay);
+}
+
+void WeaponLoader::onRetryTimer()
+{
+    startRequest();
 }
 
 void WeaponLoader::onNetworkReply(QNetworkReply *reply)
@@ -86,107 +310,224 @@ void WeaponLoader::onNetworkReply(QNetworkReply *reply)
         return;
     }
     
+    // Not modified: keep the current catalog, nothing to parse or reindex
+    if (reply->error() == QNetworkReply::NoError
+        && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        qDebug() << "Weapons list not modified";
+        m_currentReply = nullptr;
+        reply->deleteLater();
+        m_retryCount = 0;
+        m_backgroundRequest = false;
+        m_refreshPending = false;
+        setFreshness(QDateTime::currentDateTime(), QString());
+        emit weaponsUnchanged();
+        return;
+    }
+    
     if (reply->error() == QNetworkReply::NoError) {
         QByteArray responseData = reply->readAll();
-        QJsonDocument doc = QJsonDocument::fromJson(responseData);
+        QByteArray etag = reply->rawHeader("ETag");
+        QByteArray lastModified = reply->rawHeader("Last-Modified");
         
-        if (doc.isObject()) {
-            QJsonObject obj = doc.object();
-            if (obj.contains("weapons") && obj["success"].toBool()) {
-                QJsonArray weapons = obj["weapons"].toArray();
-                
-                // Process weapons to add season info from traitIds
-                QJsonArray processedWeapons;
-                for (const QJsonValue &value : weapons) {
-                    QJsonObject weapon = value.toObject();
-                    
-                    // Extract exotic status from tierType (6 = Exotic) or tierTypeName
-                    bool isExotic = (weapon["tierType"].toInt() == 6) || 
-                                   (weapon["tierTypeName"].toString().toLower() == "exotic");
-                    weapon["isExotic"] = isExotic;
-                    
-                    // Extract season from traitIds
-                    if (weapon.contains("traitIds")) {
-                        QJsonArray traitIds = weapon["traitIds"].toArray();
-                        int seasonNumber = SeasonMapping::instance().getSeasonNumber(traitIds);
-                        QString seasonName = SeasonMapping::instance().getSeasonName(traitIds);
-                        QString seasonDisplay = SeasonMapping::instance().getSeasonFromTraitIds(traitIds);
-                        weapon["seasonNumber"] = seasonNumber;
-                        weapon["seasonName"] = seasonName;
-                        // Add a searchable season field that always contains "Season X" format
-                        // Even if seasonNumber is 0, we use "Season 0" so "Season" search works
-                        weapon["season"] = QString("Season %1").arg(seasonNumber);
-                        weapon["seasonDisplay"] = seasonDisplay;
-                    } else {
-                        // Fallback for weapons without traitIds
-                        weapon["seasonNumber"] = 0;
-                        weapon["seasonName"] = "";
-                        weapon["season"] = "Season";
-                        weapon["seasonDisplay"] = "";
-                    }
-                    
-                    processedWeapons.append(weapon);
-                }
-                
-                qDebug() << "Loaded" << processedWeapons.size() << "weapons";
-                m_currentReply = nullptr;
-                
-                // Emit signal for QML connections
-                emit weaponsLoaded(processedWeapons);
-                
-                if (m_callback) {
-                    m_callback(processedWeapons);
-                }
-            } else {
-                qWarning() << "API response does not contain weapons array";
-                // Retry on invalid response
-                if (m_retryCount < MAX_RETRIES) {
-                    m_retryCount++;
-                    qDebug() << "Invalid response, retrying... (" << m_retryCount << "/" << MAX_RETRIES << ")";
-                    reply->deleteLater();
-                    m_currentReply = nullptr;
-                    startRequest();
-                    return;
-                }
-            }
-        } else {
-            qWarning() << "API response is not a JSON object";
-            // Retry on invalid response
-            if (m_retryCount < MAX_RETRIES) {
-                m_retryCount++;
-                qDebug() << "Invalid JSON, retrying... (" << m_retryCount << "/" << MAX_RETRIES << ")";
-                reply->deleteLater();
-                m_currentReply = nullptr;
-                startRequest();
-                return;
-            }
-        }
+        // Parse, post-process and index on a worker, only the finished catalog comes back
+        // The current catalog is immutable, so the worker can diff against it safely
+        WeaponCatalogPtr base = m_catalog;
+        QByteArray baseHash = m_payloadHash;
+        QFuture<ProcessedResponse> future = QtConcurrent::run([responseData, etag, lastModified, base, baseHash]() {
+            return processResponse(responseData, etag, lastModified, base, baseHash);
+        });
+        m_processingWatcher->setFuture(future);
     } else {
         qWarning() << "Failed to load weapons:" << reply->errorString();
         // Retry on network error
-        if (m_retryCount < MAX_RETRIES) {
-            m_retryCount++;
-            qDebug() << "Network error, retrying... (" << m_retryCount << "/" << MAX_RETRIES << ")";
-            reply->deleteLater();
-            m_currentReply = nullptr;
-            startRequest();
-            return;
-        } else {
-            // Return empty array on final failure
-            if (m_callback) {
-                m_callback(QJsonArray());
-            }
-        }
+        handleFailure(reply->errorString());
     }
     
     m_currentReply = nullptr;
     reply->deleteLater();
 }
 
+// Runs on a worker thread: everything here must only touch its arguments
+WeaponLoader::ProcessedResponse WeaponLoader::processResponse(const QByteArray &responseData,
+                                                              const QByteArray &etag,
+                                                              const QByteArray &lastModified,
+                                                              const WeaponCatalogPtr &base,
+                                                              const QByteArray &baseHash)
+{
+    ProcessedResponse result;
+    result.etag = etag;
+    result.lastModified = lastModified;
+    
+    // Servers without validators still send the same bytes when nothing changed:
+    // hashing them is far cheaper than parsing and diffing the list
+    result.payloadHash = QCryptographicHash::hash(responseData, QCryptographicHash::Sha1);
+    if (base && result.payloadHash == baseHash) {
+        result.unchanged = true;
+        return result;
+    }
+    
+    QJsonDocument doc = QJsonDocument::fromJson(responseData);
+    if (!doc.isObject()) {
+        qWarning() << "API response is not a JSON object";
+        result.error = "API response is not a JSON object";
+        return result;
+    }
+    
+    QJsonObject obj = doc.object();
+    if (!obj.contains("weapons") || !obj["success"].toBool()) {
+        qWarning() << "API response does not contain weapons array";
+        result.error = "API response does not contain weapons array";
+        return result;
+    }
+    
+    QJsonArray weapons = obj["weapons"].toArray();
+    
+    // Process weapons to add season info from traitIds
+    QJsonArray processedWeapons;
+    for (const QJsonValue &value : weapons) {
+        QJsonObject weapon = value.toObject();
+        
+        // Extract exotic status from tierType (6 = Exotic) or tierTypeName
+        bool isExotic = (weapon["tierType"].toInt() == 6) || 
+                       (weapon["tierTypeName"].toString().toLower() == "exotic");
+        weapon["isExotic"] = isExotic;
+        
+        // Extract season from traitIds
+        if (weapon.contains("traitIds")) {
+            QJsonArray traitIds = weapon["traitIds"].toArray();
+            const SeasonInfo *season = SeasonMapping::instance().resolve(traitIds);
+            int seasonNumber = season ? season->number : 0;
+            weapon["seasonNumber"] = seasonNumber;
+            weapon["seasonName"] = season ? season->shortName : QString();
+            // Add a searchable season field that always contains "Season X" format
+            // Even if seasonNumber is 0, we use "Season 0" so "Season" search works
+            weapon["season"] = QString("Season %1").arg(seasonNumber);
+            weapon["seasonDisplay"] = season ? season->display : QString();
+        } else {
+            // Fallback for weapons without traitIds
+            weapon["seasonNumber"] = 0;
+            weapon["seasonName"] = "";
+            weapon["season"] = "Season";
+            weapon["seasonDisplay"] = "";
+        }
+        
+        processedWeapons.append(weapon);
+    }
+    
+    qDebug() << "Loaded" << processedWeapons.size() << "weapons";
+    
+    // Diff against the published catalog so only added and changed weapons are reindexed.
+    // Only the projected records are kept, the JSON tree is released when this returns.
+    result.catalog = WeaponCatalog::update(base, processedWeapons);
+    if (base) {
+        const WeaponCatalog::Delta &delta = result.catalog->delta();
+        qDebug() << "Catalog delta:" << delta.added.size() << "added," << delta.changed.size() << "changed,"
+                 << delta.removed.size() << "removed";
+    }
+    saveSnapshot(result.catalog, etag, lastModified, result.payloadHash);
+    return result;
+}
+
+void WeaponLoader::onProcessingFinished()
+{
+    ProcessedResponse result = m_processingWatcher->result();
+    m_backgroundRequest = false;  // Whatever comes next is not this scheduled refresh
+    
+    if (result.unchanged) {
+        qDebug() << "Weapons list content unchanged";
+        m_retryCount = 0;
+        m_refreshPending = false;
+        setFreshness(QDateTime::currentDateTime(), QString());
+        emit weaponsUnchanged();
+    } else if (result.catalog) {
+        m_etag = result.etag;
+        m_lastModified = result.lastModified;
+        m_payloadHash = result.payloadHash;
+        m_retryCount = 0;
+        m_refreshPending = false;
+        setFreshness(QDateTime::currentDateTime(), QString());
+        publishCatalog(result.catalog);
+    } else if (!m_requestQueued) {
+        // Retry on invalid response
+        handleFailure(result.error);
+    }
+    
+    // A reload asked for while this response was processed revalidates against what was just published
+    if (m_requestQueued) {
+        startRequest();
+    }
+}
+
 void WeaponLoader::reload()
 {
     qDebug() << "Reloading weapons (F5 pressed)...";
     emit reloadStarted();
     m_retryCount = 0;
+    m_backgroundRequest = false;
+    m_refreshPending = false;  // This reload brings the catalog up to date
+    startRequest();
+}
+
+bool WeaponLoader::isLoading() const
+{
+    return m_currentReply || m_processingWatcher->isRunning() || m_retryTimer->isActive() || m_requestQueued;
+}
+
+void WeaponLoader::onRefreshTimer()
+{
+    // A load or retry cycle is already running, it will bring the catalog up to date
+    if (isLoading()) {
+        return;
+    }
+    
+    // Don't swap the list under the user's cursor, catch up once the window hides
+    if (m_windowVisible) {
+        m_refreshPending = true;
+        return;
+    }
+    
+    startBackgroundRefresh();
+}
+
+void WeaponLoader::startBackgroundRefresh()
+{
+    qDebug() << "Scheduled weapons refresh";
+    m_refreshPending = false;
+    m_retryCount = 0;
+    m_backgroundRequest = true;
     startRequest();
 }
+
+void WeaponLoader::setWindowVisible(bool visible)
+{
+    m_windowVisible = visible;
+    if (!visible && m_refreshPending) {
+        // Never replace a load the user started (F5) or a retry cycle with a background request
+        if (isLoading()) {
+            m_refreshPending = false;
+            return;
+        }
+        startBackgroundRefresh();
+    }
+}
+
+void WeaponLoader::setRefreshIntervalMinutes(int minutes)
+{
+    minutes = qBound(0, minutes, MAX_REFRESH_MINUTES);
+    if (m_refreshIntervalMinutes == minutes)
+        return;
+
+    m_refreshIntervalMinutes = minutes;
+    if (minutes > 0) {
+        m_refreshTimer->start(minutes * 60 * 1000);
+    } else {
+        m_refreshTimer->stop();
+        m_refreshPending = false;
+    }
+    
+    // Save preference
+    QSettings settings("Godroll.tv", "GodrollLauncher");
+    settings.setValue("refreshIntervalMinutes", minutes);
+    
+    emit refreshIntervalMinutesChanged();
+}
@@ -6,39 +6,129 @@
 #include <QNetworkReply>
 #include <QJsonArray>
 #include <QTimer>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QUrl>
+#include <QFutureWatcher>
 #include <functional>
+#include "weaponcatalog.h"
 
 class WeaponLoader : public QObject
 {
     Q_OBJECT
+    Q_PROPERTY(QDateTime lastUpdated READ lastUpdated NOTIFY freshnessChanged)
+    Q_PROPERTY(QString lastError READ lastError NOTIFY freshnessChanged)
+    Q_PROPERTY(bool stale READ stale NOTIFY freshnessChanged)
+    Q_PROPERTY(int refreshIntervalMinutes READ refreshIntervalMinutes WRITE setRefreshIntervalMinutes NOTIFY refreshIntervalMinutesChanged)
 
 public:
     explicit WeaponLoader(QObject *parent = nullptr);
 
-    void loadWeapons(std::function<void(const QJsonArray&)> callback);
+    // Freshness of the published catalog: when it was last confirmed by the API and why
+    // the latest refresh failed (empty once a refresh succeeds)
+    QDateTime lastUpdated() const { return m_lastUpdated; }
+    QString lastError() const { return m_lastError; }
+    bool stale() const { return !m_lastError.isEmpty(); }
+
+    // Background refresh while the app sits in the tray (0 = only at launch and on F5)
+    int refreshIntervalMinutes() const { return m_refreshIntervalMinutes; }
+    void setRefreshIntervalMinutes(int minutes);
+
+    // Weapons list URL, defaults to GODROLL_API_URL from the environment or the public API
+    // (point it at a local server to try slow, failing or 304 responses)
+    void setEndpoint(const QUrl &url);
+    QUrl endpoint() const { return m_endpoint; }
+
+    // Request timeout and first retry delay (doubled per attempt), shortened by tests
+    void setRequestTimeout(int ms) { m_timeoutMs = ms; }
+    void setRetryBaseDelay(int ms) { m_retryBaseMs = ms; }
+
+    // Publishes the on-disk snapshot first (if valid), then refreshes from the API
+    void loadWeapons(std::function<void(const WeaponCatalogPtr&)> callback);
     
     // QML-callable reload method
     Q_INVOKABLE void reload();
+    
+    // Scheduled refreshes wait while the launcher window is shown
+    Q_INVOKABLE void setWindowVisible(bool visible);
 
 signals:
-    void weaponsLoaded(const QJsonArray &weapons);
+    void weaponsLoaded();
+    void catalogLoaded(const WeaponCatalogPtr &catalog);
+    void weaponsUnchanged();  // Server answered 304, the published catalog is still current
     void reloadStarted();
+    void loadFailed(const QString &error);  // MAX_RETRIES attempts failed, retrying continues in the background
+    void freshnessChanged();
+    void refreshIntervalMinutesChanged();
 
 private slots:
     void onNetworkReply(QNetworkReply *reply);
     void onTimeout();
+    void onRetryTimer();
+    void onRefreshTimer();
+    void onProcessingFinished();
 
 private:
+    // Result of parsing and indexing one API response on a worker thread
+    struct ProcessedResponse {
+        WeaponCatalogPtr catalog;  // Null when the response was not a valid weapons list
+        QString error;
+        QByteArray payloadHash;    // SHA-1 of the response body
+        bool unchanged = false;    // Body is identical to the one the base catalog came from
+        QByteArray etag;
+        QByteArray lastModified;
+    };
+
     void startRequest();
     void cleanupCurrentRequest();
+    void handleFailure(const QString &error);
+    void setFreshness(const QDateTime &lastUpdated, const QString &lastError);
+    void startBackgroundRefresh();
+    bool isLoading() const;  // A request, its processing or a retry is in progress
+    void publishCatalog(const WeaponCatalogPtr &catalog);
+
+    // Binary snapshot of the last processed catalog in the app data directory
+    static QString snapshotPath();
+    WeaponCatalogPtr loadSnapshot();
+    static void saveSnapshot(const WeaponCatalogPtr &catalog, const QByteArray &etag, const QByteArray &lastModified,
+                             const QByteArray &payloadHash);
+    static ProcessedResponse processResponse(const QByteArray &responseData, const QByteArray &etag, const QByteArray &lastModified,
+                                             const WeaponCatalogPtr &base, const QByteArray &baseHash);
 
     QNetworkAccessManager *m_networkManager;
-    std::function<void(const QJsonArray&)> m_callback;
+    QUrl m_endpoint;
+    QElapsedTimer m_loadTimer;   // Started by loadWeapons() to report time until searchable
+    bool m_searchableLogged = false;
+    std::function<void(const WeaponCatalogPtr&)> m_callback;
+    WeaponCatalogPtr m_catalog;  // Last published catalog (snapshot or network)
+    QByteArray m_etag;           // HTTP validators of m_catalog, sent with the next request
+    QByteArray m_lastModified;
+    QByteArray m_payloadHash;    // SHA-1 of the response body m_catalog was built from
     QNetworkReply *m_currentReply;
     QTimer *m_timeoutTimer;
+    QTimer *m_retryTimer;
+    QTimer *m_refreshTimer;
+    QFutureWatcher<ProcessedResponse> *m_processingWatcher;
     int m_retryCount;
-    static const int MAX_RETRIES = 3;
+    int m_timeoutMs = TIMEOUT_MS;
+    int m_retryBaseMs = RETRY_BASE_MS;
+    QDateTime m_lastUpdated;
+    QString m_lastError;
+    int m_refreshIntervalMinutes;
+    bool m_windowVisible = false;
+    bool m_refreshPending = false;     // Refresh came due while the window was visible
+    bool m_backgroundRequest = false;  // Current request is a scheduled refresh
+    bool m_requestQueued = false;      // Asked for while a response was still being processed
+    static const QString DEFAULT_API_URL;
+    static const int MAX_RETRIES = 3;          // Failed attempts before loadFailed is reported
+    static const int RETRY_BASE_MS = 2000;     // First retry delay, doubled per attempt
+    static const int RETRY_MAX_MS = 300000;    // Backoff cap (5 minutes)
+    static const int DEFAULT_REFRESH_MINUTES = 360;
+    static const int MAX_REFRESH_MINUTES = 7 * 24 * 60;  // One week, keeps the interval in ms within int
     static const int TIMEOUT_MS = 15000; // 15 seconds
+    static const quint32 SNAPSHOT_MAGIC = 0x47524353; // "GRCS"
+    static const quint32 SNAPSHOT_VERSION = 6;         // Bump when the payload layout changes
+    static const int SNAPSHOT_COMPRESSION_LEVEL = 1;   // zlib level, favours load speed over size
 };
 
 #endif // WEAPONLOADER_H
@@ -0,0 +1,429 @@
+#include "weaponrow.h"
+#include "iconcache.h"
+#include <QFontMetricsF>
+#include <QQuickWindow>
+#include <QSGNode>
+#include <QSGGeometryNode>
+#include <QSGImageNode>
+#include <QSGTextNode>
+#include <QSGTexture>
+#include <QSGVertexColorMaterial>
+#include <QtMath>
+#include <algorithm>
+#include <iterator>
+
+IconCache *WeaponRow::s_iconCache = nullptr;
+
+// Colors and metrics follow WeaponItem.qml
+static const QColor ACCENT_COLOR("#09d7d0");
+static const QColor MATCH_COLOR("#d7a909");
+static const QColor MATCH_BACKGROUND("#5a4a2d");
+static const int ICON_BOX_SIZE = 68;
+static const int ICON_SIZE = 52;
+static const int TYPE_ICON_SIZE = 18;
+static const int CORNER_SEGMENTS = 6;  // Arc steps per rounded corner
+
+// Root node of a row: shapes below icons below text. Shape and text nodes are rebuilt with
+// each layout; icon textures are kept until the image itself changes.
+class RowNode : public QSGNode
+{
+public:
+    RowNode()
+    {
+        appendChildNode(shapes);
+        appendChildNode(images);
+        appendChildNode(texts);
+    }
+
+    ~RowNode() override
+    {
+        // Hidden icons are detached, so no parent deletes them; textures are owned here
+        for (int i = 0; i < ICON_COUNT; ++i) {
+            if (icons[i] && !icons[i]->parent()) {
+                delete icons[i];
+            }
+            delete textures[i];
+        }
+    }
+
+    static void clear(QSGNode *layer)
+    {
+        while (QSGNode *child = layer->firstChild()) {
+            layer->removeChildNode(child);
+            delete child;
+        }
+    }
+
+    static const int ICON_COUNT = 3;  // Weapon, damage type, ammo type
+
+    QSGNode *shapes = new QSGNode;
+    QSGNode *images = new QSGNode;
+    QSGNode *texts = new QSGNode;
+    QSGImageNode *icons[ICON_COUNT] = {};
+    QSGTexture *textures[ICON_COUNT] = {};
+    qint64 imageKeys[ICON_COUNT] = {};  // QImage::cacheKey() of the uploaded texture, 0 for none
+};
+
+// Filled rounded rectangle with a half-pixel alpha fringe on the outline for antialiasing:
+// a fan of triangles from the center plus a ring of quads (vertex colors are premultiplied)
+static QSGGeometryNode *roundedRectNode(const QRectF &rect, qreal radius, const QColor &color)
+{
+    radius = qMin(radius, qMin(rect.width(), rect.height()) / 2);
+    const QPointF corners[4] = {
+        rect.topRight() + QPointF(-radius, radius),
+        rect.bottomRight() + QPointF(-radius, -radius),
+        rect.bottomLeft() + QPointF(radius, -radius),
+        rect.topLeft() + QPointF(radius, radius)
+    };
+    QVector<QPointF> normals;
+    QVector<QPointF> points;
+    for (int corner = 0; corner < 4; ++corner) {
+        for (int step = 0; step <= CORNER_SEGMENTS; ++step) {
+            const qreal angle = qDegreesToRadians(-90.0 + corner * 90.0 + step * 90.0 / CORNER_SEGMENTS);
+            const QPointF normal(qCos(angle), qSin(angle));
+            normals.append(normal);
+            points.append(corners[corner] + normal * radius);
+        }
+    }
+
+    const int count = points.size();
+    auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 1 + 2 * count, 9 * count,
+                                     QSGGeometry::UnsignedShortType);
+    geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+    const uchar alpha = uchar(color.alpha());
+    const uchar red = uchar(color.red() * alpha / 255);
+    const uchar green = uchar(color.green() * alpha / 255);
+    const uchar blue = uchar(color.blue() * alpha / 255);
+    QSGGeometry::ColoredPoint2D *vertices = geometry->vertexDataAsColoredPoint2D();
+    const QPointF center = rect.center();
+    vertices[0].set(float(center.x()), float(center.y()), red, green, blue, alpha);
+    for (int i = 0; i < count; ++i) {
+        const QPointF inner = points[i] - normals[i] * 0.5;
+        const QPointF outer = points[i] + normals[i] * 0.5;
+        vertices[1 + i].set(float(inner.x()), float(inner.y()), red, green, blue, alpha);
+        vertices[1 + count + i].set(float(outer.x()), float(outer.y()), 0, 0, 0, 0);
+    }
+    quint16 *indices = geometry->indexDataAsUShort();
+    for (int i = 0; i < count; ++i) {
+        const quint16 inner = quint16(1 + i);
+        const quint16 nextInner = quint16(1 + (i + 1) % count);
+        const quint16 outer = quint16(inner + count);
+        const quint16 nextOuter = quint16(nextInner + count);
+        const quint16 triangles[9] = {0, inner, nextInner, inner, outer, nextInner, nextInner, outer, nextOuter};
+        std::copy(std::begin(triangles), std::end(triangles), indices + 9 * i);
+    }
+
+    auto *node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setMaterial(new QSGVertexColorMaterial);
+    node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+    return node;
+}
+
+static QRectF fitted(const QRectF &target, const QImage &image)
+{
+    if (image.isNull()) {
+        return QRectF();
+    }
+    const QSizeF size = QSizeF(image.size()).scaled(target.size(), Qt::KeepAspectRatio);
+    return QRectF(target.center() - QPointF(size.width() / 2, size.height() / 2), size);
+}
+
+WeaponRow::WeaponRow(QQuickItem *parent)
+    : QQuickItem(parent)
+{
+    setFlag(ItemHasContents);
+    setAcceptHoverEvents(true);
+    setAcceptedMouseButtons(Qt::LeftButton | Qt::MiddleButton);
+    setCursor(Qt::PointingHandCursor);
+    
+    connect(this, &WeaponRow::rowChanged, this, &WeaponRow::scheduleLayout);
+    connect(this, &WeaponRow::hoveredChanged, this, &WeaponRow::scheduleLayout);
+    if (s_iconCache) {
+        connect(s_iconCache, &IconCache::decodedImageReady, this, [this](const QString &path) {
+            if (path == m_icon || path == m_damageTypeIcon || path == m_ammoTypeIcon) {
+                scheduleLayout();
+            }
+        });
+    }
+}
+
+void WeaponRow::setIconCache(IconCache *cache)
+{
+    s_iconCache = cache;
+}
+
+void WeaponRow::setHovered(bool hovered)
+{
+    if (m_hovered != hovered) {
+        m_hovered = hovered;
+        emit hoveredChanged();
+    }
+}
+
+void WeaponRow::scheduleLayout()
+{
+    polish();
+    update();
+}
+
+void WeaponRow::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size()) {
+        scheduleLayout();
+    }
+}
+
+// Same cache entries the image provider uses for WeaponItem.qml (size in device pixels)
+QImage WeaponRow::iconImage(const QString &path, int logicalSize) const
+{
+    if (path.isEmpty() || !s_iconCache) {
+        return QImage();
+    }
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    const QSize size = QSize(logicalSize, logicalSize) * dpr;
+    QImage image = s_iconCache->decodedImage(path, size);
+    if (image.isNull()) {
+        s_iconCache->requestDecoded(path, size);
+    }
+    return image;
+}
+
+// One single-line layout per run: QSGTextNode shapes it as a whole, so format ranges
+// (match highlights) keep kerning across their boundaries
+void WeaponRow::addText(const QPointF &position, const QString &text, const QFont &font, const QColor &color,
+                        const QList<QTextLayout::FormatRange> &formats)
+{
+    TextRun run;
+    run.position = position;
+    run.color = color;
+    run.layout = std::make_unique<QTextLayout>(text, font);
+    QTextOption option;
+    option.setWrapMode(QTextOption::NoWrap);
+    run.layout->setTextOption(option);
+    run.layout->setFormats(formats);
+    run.layout->beginLayout();
+    QTextLine line = run.layout->createLine();
+    if (line.isValid()) {
+        line.setLineWidth(width());
+        line.setPosition(QPointF(0, 0));
+    }
+    run.layout->endLayout();
+    m_texts.push_back(std::move(run));
+}
+
+// Metadata badge: plain text, or text on a highlighted pill when the field matched the query
+qreal WeaponRow::addBadge(qreal x, qreal y, qreal rowHeight, const QString &text, const QFont &font,
+                          const QColor &color, bool matched)
+{
+    const QFontMetricsF metrics(font);
+    const qreal padding = matched ? 6 : 0;
+    const qreal textWidth = metrics.horizontalAdvance(text);
+    if (matched) {
+        m_shapes.append({QRectF(x, y, textWidth + padding * 2, rowHeight), 4, MATCH_BACKGROUND});
+    }
+    addText(QPointF(x + padding, y + (rowHeight - metrics.height()) / 2), text, font, matched ? MATCH_COLOR : color);
+    return textWidth + padding * 2;
+}
+
+// GUI thread: resolve icons (requesting missing ones) and lay out every shape and text run
+void WeaponRow::updatePolish()
+{
+    m_shapes.clear();
+    m_texts.clear();
+    const QRectF bounds = boundingRect();
+    
+    // Background and left accent
+    m_shapes.append({bounds, 9, QColor(m_highlighted ? "#CC2a2a2a" : (m_hovered ? "#CC242424" : "#CC1e1e1e"))});
+    if (m_highlighted) {
+        m_shapes.append({QRectF(0, 8, 3, bounds.height() - 16), 2, ACCENT_COLOR});
+    }
+    
+    // Weapon icon on its dark tile
+    const QRectF iconBox(15, (bounds.height() - ICON_BOX_SIZE) / 2, ICON_BOX_SIZE, ICON_BOX_SIZE);
+    m_shapes.append({iconBox, 7, QColor("#151515")});
+    const qreal iconMargin = (ICON_BOX_SIZE - ICON_SIZE) / 2.0;
+    m_icons[WeaponIcon].image = iconImage(m_icon, ICON_SIZE);
+    m_icons[WeaponIcon].rect = fitted(iconBox.adjusted(iconMargin, iconMargin, -iconMargin, -iconMargin),
+                                      m_icons[WeaponIcon].image);
+    
+    QFont nameFont(m_fontFamily);
+    nameFont.setPixelSize(20);
+    nameFont.setWeight(QFont::Bold);
+    QFont infoFont(m_fontFamily);
+    infoFont.setPixelSize(14);
+    QFont typeFont = infoFont;
+    typeFont.setWeight(QFont::Medium);
+    QFont separatorFont(m_fontFamily);
+    separatorFont.setPixelSize(12);
+    
+    const QFontMetricsF nameMetrics(nameFont);
+    const QFontMetricsF infoMetrics(infoFont);
+    const bool anyMatched = !m_matchedField.isEmpty();
+    const qreal nameHeight = nameMetrics.height();
+    const qreal infoHeight = infoMetrics.height() + (anyMatched ? 6 : 0);
+    const qreal left = iconBox.right() + 16;
+    const qreal right = bounds.width() - 15;
+    qreal y = (bounds.height() - (nameHeight + 5 + infoHeight)) / 2;
+    
+    // Name, elided to leave room for the badges, with matched ranges in the accent color
+    const qreal reserved = (m_isHolofoil ? 80 : 0) + 2 * (TYPE_ICON_SIZE + 8);
+    const QString name = nameMetrics.elidedText(m_name, Qt::ElideRight, qMax<qreal>(0, right - reserved - left));
+    const int visible = name == m_name ? int(name.size()) : qMax(0, int(name.size()) - 1);  // Without the ellipsis
+    QList<QTextLayout::FormatRange> highlights;
+    for (int i = 0; i + 1 < m_matchSpans.size(); i += 2) {
+        const int start = m_matchSpans[i].toInt();
+        const int end = qMin(start + m_matchSpans[i + 1].toInt(), visible);
+        if (start >= 0 && end > start) {
+            QTextLayout::FormatRange range;
+            range.start = start;
+            range.length = end - start;
+            range.format.setForeground(ACCENT_COLOR);
+            highlights.append(range);
+        }
+    }
+    addText(QPointF(left, y), name, nameFont, QColor(m_highlighted ? "#ffffff" : "#cccccc"), highlights);
+    qreal x = left + nameMetrics.horizontalAdvance(name);
+    
+    // Holofoil badge (static here, the QML row animates it)
+    if (m_isHolofoil) {
+        QFont badgeFont(m_fontFamily);
+        badgeFont.setPixelSize(10);
+        badgeFont.setWeight(QFont::Bold);
+        const QFontMetricsF badgeMetrics(badgeFont);
+        const QString label = QStringLiteral("HOLOFOIL");
+        const qreal labelWidth = badgeMetrics.horizontalAdvance(label);
+        const QRectF badge(x + 8, y + (nameHeight - badgeMetrics.height() - 6) / 2,
+                           labelWidth + 12, badgeMetrics.height() + 6);
+        m_shapes.append({badge, 4, QColor("#8b5cf6")});
+        m_shapes.append({badge.adjusted(1, 1, -1, -1), 3, QColor("#2d1f4e")});
+        addText(QPointF(badge.x() + (badge.width() - labelWidth) / 2, badge.y() + 3), label, badgeFont, Qt::white);
+        x = badge.right();
+    }
+    
+    // Damage and ammo type icons
+    const QString typeIcons[2] = {m_damageTypeIcon, m_ammoTypeIcon};
+    for (int i = 0; i < 2; ++i) {
+        IconSlot &slot = m_icons[DamageTypeIcon + i];
+        slot.image = iconImage(typeIcons[i], TYPE_ICON_SIZE);
+        slot.rect = QRectF();
+        if (!typeIcons[i].isEmpty()) {
+            x += 8;
+            slot.rect = fitted(QRectF(x, y + (nameHeight - TYPE_ICON_SIZE) / 2, TYPE_ICON_SIZE, TYPE_ICON_SIZE),
+                               slot.image);
+            x += TYPE_ICON_SIZE;
+        }
+    }
+    
+    // Metadata: TYPE • Frame • Season N • Season name
+    y += nameHeight + 5;
+    x = left;
+    bool first = true;
+    auto addField = [&](const QString &text, const QString &field, const QFont &font, const QColor &color) {
+        if (text.isEmpty()) {
+            return;
+        }
+        if (!first) {
+            x += 7;
+            x += addBadge(x, y, infoHeight, QStringLiteral("•"), separatorFont, QColor("#555555"), false);
+            x += 7;
+        }
+        first = false;
+        x += addBadge(x, y, infoHeight, text, font, color, m_matchedField.contains(field));
+    };
+    addField(m_weaponType.toUpper(), "weaponType", typeFont, QColor("#999999"));
+    addField(m_frameType, "frameType", infoFont, QColor("#888888"));
+    addField(m_seasonNumber > 0 ? QString("Season %1").arg(m_seasonNumber) : QString(), "seasonNumber", infoFont, QColor("#666666"));
+    addField(m_seasonName, "seasonName", infoFont, QColor("#666666"));
+}
+
+// Render thread, GUI thread blocked: turn the layout into nodes
+QSGNode *WeaponRow::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *node = static_cast<RowNode *>(oldNode);
+    if (!node) {
+        node = new RowNode;
+    }
+    
+    RowNode::clear(node->shapes);
+    for (const Shape &shape : std::as_const(m_shapes)) {
+        if (!shape.rect.isEmpty()) {
+            node->shapes->appendChildNode(roundedRectNode(shape.rect, shape.radius, shape.color));
+        }
+    }
+    
+    // Upload an icon only when its image changed, not on every rebind
+    static_assert(IconCount == RowNode::ICON_COUNT, "one icon node per slot");
+    for (int i = 0; i < IconCount; ++i) {
+        const IconSlot &slot = m_icons[i];
+        QSGImageNode *&image = node->icons[i];
+        const qint64 key = slot.image.isNull() || slot.rect.isEmpty() ? 0 : slot.image.cacheKey();
+        if (key == 0) {
+            if (image && image->parent()) {
+                node->images->removeChildNode(image);
+            }
+            continue;
+        }
+        if (!image) {
+            image = window()->createImageNode();
+            image->setFiltering(QSGTexture::Linear);
+        }
+        if (key != node->imageKeys[i]) {
+            QSGTexture *texture = window()->createTextureFromImage(slot.image);
+            image->setTexture(texture);
+            delete node->textures[i];
+            node->textures[i] = texture;
+            node->imageKeys[i] = key;
+        }
+        image->setRect(slot.rect);
+        if (!image->parent()) {
+            node->images->appendChildNode(image);
+        }
+    }
+    
+    RowNode::clear(node->texts);
+    for (const TextRun &run : m_texts) {
+        QSGTextNode *text = window()->createTextNode();
+        text->setColor(run.color);
+        text->addTextLayout(run.position, run.layout.get());
+        node->texts->appendChildNode(text);
+    }
+    return node;
+}
+
+void WeaponRow::hoverEnterEvent(QHoverEvent *event)
+{
+    setHovered(true);
+    event->ignore();
+}
+
+void WeaponRow::hoverMoveEvent(QHoverEvent *event)
+{
+    const QPointF windowPos = mapToScene(event->position());
+    emit mouseMoved(windowPos.x(), windowPos.y());
+    event->ignore();
+}
+
+void WeaponRow::hoverLeaveEvent(QHoverEvent *event)
+{
+    setHovered(false);
+    event->ignore();
+}
+
+void WeaponRow::mousePressEvent(QMouseEvent *event)
+{
+    event->accept();  // Needed to receive the release
+}
+
+void WeaponRow::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!contains(event->position())) {
+        return;
+    }
+    if (event->button() == Qt::MiddleButton) {
+        emit middleClicked();
+    } else if (event->button() == Qt::LeftButton) {
+        emit clicked();
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef WEAPONROW_H
+#define WEAPONROW_H
+
+#include <QQuickItem>
+#include <QVariantList>
+#include <QStringList>
+#include <QImage>
+#include <QColor>
+#include <QRectF>
+#include <QTextLayout>
+#include <memory>
+#include <vector>
+
+class IconCache;
+
+// Optional native result row: icon, name, badges and metadata as scene graph nodes under one
+// item node, instead of the ~30 items of WeaponItem.qml. Text goes through QSGTextNode and icons
+// are uploaded once per image, so reusing a row for new data rasterizes nothing on the CPU.
+// Enabled with the nativeRows setting.
+class WeaponRow : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(QString name MEMBER m_name NOTIFY rowChanged)
+    Q_PROPERTY(QVariantList matchSpans MEMBER m_matchSpans NOTIFY rowChanged)
+    Q_PROPERTY(QString weaponType MEMBER m_weaponType NOTIFY rowChanged)
+    Q_PROPERTY(QString frameType MEMBER m_frameType NOTIFY rowChanged)
+    Q_PROPERTY(int seasonNumber MEMBER m_seasonNumber NOTIFY rowChanged)
+    Q_PROPERTY(QString seasonName MEMBER m_seasonName NOTIFY rowChanged)
+    Q_PROPERTY(QString matchedField MEMBER m_matchedField NOTIFY rowChanged)
+    Q_PROPERTY(bool isHolofoil MEMBER m_isHolofoil NOTIFY rowChanged)
+    Q_PROPERTY(QString icon MEMBER m_icon NOTIFY rowChanged)
+    Q_PROPERTY(QString damageTypeIcon MEMBER m_damageTypeIcon NOTIFY rowChanged)
+    Q_PROPERTY(QString ammoTypeIcon MEMBER m_ammoTypeIcon NOTIFY rowChanged)
+    Q_PROPERTY(QString fontFamily MEMBER m_fontFamily NOTIFY rowChanged)
+    Q_PROPERTY(bool highlighted MEMBER m_highlighted NOTIFY rowChanged)
+    Q_PROPERTY(bool hovered READ hovered WRITE setHovered NOTIFY hoveredChanged)
+
+public:
+    explicit WeaponRow(QQuickItem *parent = nullptr);
+
+    // Shared with the image provider so rows and WeaponItem.qml reuse the same decoded icons
+    static void setIconCache(IconCache *cache);
+
+
+    bool hovered() const { return m_hovered; }
+    void setHovered(bool hovered);
+
+signals:
+    void rowChanged();  // Any drawn property, lays the row out again
+    void hoveredChanged();
+    void clicked();
+    void middleClicked();
+    void mouseMoved(qreal windowX, qreal windowY);
+
+protected:
+    void updatePolish() override;
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+    void hoverEnterEvent(QHoverEvent *event) override;
+    void hoverMoveEvent(QHoverEvent *event) override;
+    void hoverLeaveEvent(QHoverEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private:
+    // Laid out on the GUI thread in updatePolish(), turned into nodes in updatePaintNode()
+    struct Shape {
+        QRectF rect;
+        qreal radius;
+        QColor color;
+    };
+    struct TextRun {
+        QPointF position;
+        QColor color;
+        std::unique_ptr<QTextLayout> layout;
+    };
+    struct IconSlot {
+        QRectF rect;
+        QImage image;
+    };
+    enum IconIndex { WeaponIcon, DamageTypeIcon, AmmoTypeIcon, IconCount };
+
+    QImage iconImage(const QString &path, int logicalSize) const;
+    qreal addBadge(qreal x, qreal y, qreal rowHeight, const QString &text, const QFont &font,
+                   const QColor &color, bool matched);
+    void addText(const QPointF &position, const QString &text, const QFont &font, const QColor &color,
+                 const QList<QTextLayout::FormatRange> &formats = {});
+    void scheduleLayout();
+
+    QVector<Shape> m_shapes;
+    std::vector<TextRun> m_texts;
+    IconSlot m_icons[IconCount];
+
+    QString m_name;
+    QVariantList m_matchSpans;
+    QString m_weaponType;
+    QString m_frameType;
+    int m_seasonNumber = 0;
+    QString m_seasonName;
+    QString m_matchedField;
+    bool m_isHolofoil = false;
+    QString m_icon;
+    QString m_damageTypeIcon;
+    QString m_ammoTypeIcon;
+    QString m_fontFamily = "Segoe UI";
+    bool m_highlighted = false;
+    bool m_hovered = false;
+
+    static IconCache *s_iconCache;
+};
+
+#endif // WEAPONROW_H
@@ -7,62 +7,87 @@
 #include <QFileInfo>
 #include <QStandardPaths>
 #include <QDir>
+#include <QThread>
+#include <QSet>
+#include <QtConcurrent>
 #include <algorithm>
-#include <tuple>
 #include <set>
 
 WeaponSearchModel::WeaponSearchModel(QObject *parent)
     : QAbstractListModel(parent)
+    , m_catalog(WeaponCatalog::build(QJsonArray()))
+    , m_resultCache(MAX_CACHED_RESULTS)
 {
     // Load saved preferences
     QSettings settings("Godroll.tv", "GodrollLauncher");
     m_autoShowLatestSeason = settings.value("autoShowLatestSeason", true).toBool();
     m_openInPWA = settings.value("openInPWA", true).toBool();
+
+    // Prefetch runs on a single idle-priority thread so it never competes with typing
+    m_prefetchPool.setMaxThreadCount(1);
+    m_prefetchPool.setThreadPriority(QThread::IdlePriority);
+
+    connect(&m_defaultViewsWatcher, &QFutureWatcher<QVector<SearchHit>>::finished,
+            this, &WeaponSearchModel::onDefaultViewsBuilt);
+}
+
+WeaponSearchModel::~WeaponSearchModel()
+{
+    // Stop any running prefetch before members go away
+    m_prefetchGeneration.ref();
+    m_prefetchPool.waitForDone();
+    m_defaultViewsWatcher.cancel();
+    m_defaultViewsPool.waitForDone();
 }
 
 int WeaponSearchModel::rowCount(const QModelIndex &parent) const
 {
     if (parent.isValid())
         return 0;
-    return m_filteredWeapons.size();
+    return m_results.size();
 }
 
 QVariant WeaponSearchModel::data(const QModelIndex &index, int role) const
 {
-    if (!index.isValid() || index.row() >= m_filteredWeapons.size())
+    if (!index.isValid() || index.row() >= m_results.size())
         return QVariant();
 
-    QJsonObject weapon = m_filteredWeapons[index.row()].toObject();
+    const SearchHit &hit = m_results[index.row()];
+    const WeaponRecord &weapon = m_catalog->weapon(hit.index);
 
     switch (role) {
     case NameRole:
-        return weapon["name"].toString();
+        return weapon.name;
     case HashRole:
-        return weapon["hash"].toVariant();
+        return weapon.hash;
     case IconRole:
-        return weapon["icon"].toString();
+        return weapon.icon;
     case WeaponTypeRole:
-        return weapon["weaponType"].toString();
+        return weapon.weaponType;
     case FrameTypeRole:
-        return weapon["frameType"].toString();
+        return weapon.frameType;
     case SeasonNumberRole:
-        return weapon["seasonNumber"].toInt();
+        return weapon.seasonNumber;
     case SeasonNameRole:
-        return weapon["seasonName"].toString();
+        return weapon.seasonName;
     case MatchedFieldRole:
-        return weapon["matchedField"].toString();
+        return hit.matchedField;
     case IsHolofoilRole:
-        return weapon["isHolofoil"].toBool();
+        return weapon.isHolofoil;
     case IsExoticRole:
-        return weapon["isExotic"].toBool();
+        return weapon.isExotic;
     case DamageTypeRole:
-        return weapon["damageType"].toString();
+        return weapon.damageType;
     case DamageTypeIconRole:
-        return weapon["damageTypeIcon"].toString();
+        return weapon.damageTypeIcon;
     case AmmoTypeRole:
-        return weapon["ammoType"].toString();
+        return weapon.ammoType;
     case AmmoTypeIconRole:
-        return weapon["ammoTypeIcon"].toString();
+        return weapon.ammoTypeIcon;
+    case MatchSpansRole:
+        return QVariant::fromValue(hit.matchSpans);
+    case HighlightedNameRole:
+        return hit.matchSpans.isEmpty() ? QString() : highlightedName(weapon.name, hit.matchSpans);
     default:
         return QVariant();
     }
@@ -85,33 +110,70 @@ QHash<int, QByteArray> WeaponSearchModel::roleNames() const
     roles[DamageTypeIconRole] = "damageTypeIcon";
     roles[AmmoTypeRole] = "ammoType";
     roles[AmmoTypeIconRole] = "ammoTypeIcon";
+    roles[MatchSpansRole] = "matchSpans";
+    roles[HighlightedNameRole] = "highlightedName";
     return roles;
 }
 
+// Built here so the delegate only binds a string: no per-row script loop or escaping in QML
+QString WeaponSearchModel::highlightedName(const QString &name, const QVector<int> &spans)
+{
+    static const QLatin1String openTag("<font color=\"#09d7d0\">");
+    static const QLatin1String closeTag("</font>");
+
+    QString result;
+    result.reserve(name.size() + spans.size() / 2 * (openTag.size() + closeTag.size()) + 16);
+    int pos = 0;
+    for (int i = 0; i + 1 < spans.size(); i += 2) {
+        result += name.mid(pos, spans[i] - pos).toHtmlEscaped();
+        result += openTag;
+        result += name.mid(spans[i], spans[i + 1]).toHtmlEscaped();
+        result += closeTag;
+        pos = spans[i] + spans[i + 1];
+    }
+    result += name.mid(pos).toHtmlEscaped();
+    return result;
+}
+
 void WeaponSearchModel::setSearchQuery(const QString &query)
 {
     if (m_searchQuery == query)
         return;
 
+    // Real input arrived: stop predicting for the previous query
+    m_prefetchGeneration.ref();
+
     m_searchQuery = query;
     filterWeapons();
     emit searchQueryChanged();
+
+    schedulePrefetch();
 }
 
 void WeaponSearchModel::setWeapons(const QJsonArray &weapons)
 {
-    m_allWeapons = weapons;
-    
-    // Find latest season number
-    m_latestSeason = 0;
-    for (const QJsonValue &value : m_allWeapons) {
-        QJsonObject weapon = value.toObject();
-        int seasonNum = weapon["seasonNumber"].toInt();
-        if (seasonNum > m_latestSeason) {
-            m_latestSeason = seasonNum;
-        }
+    setCatalog(WeaponCatalog::build(weapons));
+}
+
+void WeaponSearchModel::setCatalog(const WeaponCatalogPtr &catalog)
+{
+    if (!catalog || catalog == m_catalog) {
+        return;
     }
+
+    m_prefetchGeneration.ref();
     
+    // Cached results refer to positions in the old catalog: patch them when the new
+    // catalog was diffed against the current one, otherwise start over
+    const bool isDelta = m_catalog && catalog->delta().baseSerial == m_catalog->serial();
+    m_catalog = catalog;
+    if (isDelta) {
+        patchResultCache();
+    } else {
+        m_resultCache.clear();
+    }
+    buildDefaultViews();
+
     // Apply user preference for auto-showing latest season
     m_showLatestSeason = m_autoShowLatestSeason;
     
@@ -120,50 +182,193 @@ void WeaponSearchModel::setWeapons(const QJsonArray &weapons)
     
     // Notify that weapons are loaded
     emit weaponsLoaded();
+
+    schedulePrefetch();
 }
 
-// Helper: Get base weapon name by removing parenthetical suffixes like (Adept), (Harrowed), (Timelost)
-QString WeaponSearchModel::getBaseWeaponName(const QString &name) const
+// Pack the result ordering (score desc, season desc, name asc) into one ascending 64-bit key:
+// bits 63-32 inverted score, 31-20 inverted season, 19-0 alphabetical name rank
+quint64 WeaponSearchModel::rankingKey(int score, int seasonNum, int nameRank)
 {
-    // Remove any parenthetical suffix: "Nullify (Adept)" -> "Nullify"
-    QString baseName = name;
-    int parenIndex = baseName.indexOf('(');
-    if (parenIndex > 0) {
-        baseName = baseName.left(parenIndex).trimmed();
+    return (static_cast<quint64>(0x7fffffff - score) << 32)
+         | (static_cast<quint64>(0xfff - qBound(0, seasonNum, 0xfff)) << 20)
+         | static_cast<quint64>(qMin(nameRank, 0xfffff));
+}
+
+// Results only depend on the lowercased, trimmed query (and the latest-season toggle for empty queries)
+QString WeaponSearchModel::cacheKey(const QString &query, bool showLatestSeason)
+{
+    return (showLatestSeason ? QStringLiteral("1:") : QStringLiteral("0:")) + query.toLower().trimmed();
+}
+
+// Keep cached results that a catalog delta cannot have affected, with indices moved to the new catalog.
+// A result survives when none of its hits was removed or changed and no added or changed weapon matches
+// its query; ranking among unchanged weapons cannot move, so the list is still exact.
+void WeaponSearchModel::patchResultCache()
+{
+    const WeaponCatalog::Delta &delta = m_catalog->delta();
+
+    // Index only the new and changed weapons to test cached queries against them
+    QVector<WeaponRecord> deltaWeapons;
+    for (int i : delta.added) {
+        deltaWeapons.append(m_catalog->weapon(i));
+    }
+    for (int i : delta.changed) {
+        deltaWeapons.append(m_catalog->weapon(i));
+    }
+    const WeaponCatalogPtr deltaCatalog = WeaponCatalog::build(deltaWeapons);
+
+    const QList<QString> keys = m_resultCache.keys();
+    for (const QString &key : keys) {
+        SearchResult *result = m_resultCache.take(key);
+        const bool showLatestSeason = key.startsWith(QStringLiteral("1:"));
+        const QueryPlan plan = parseQuery(*deltaCatalog, key.mid(2));
+
+        // Source filters, -! and flag-only views depend on the whole catalog, recompute them on demand
+        bool valid = !plan.queryLower.isEmpty() && plan.sourceFilters.isEmpty() && !plan.uniqueByName;
+
+        for (int h = 0; valid && h < result->hits.size(); ++h) {
+            const int newIndex = delta.baseToNew.value(result->hits[h].index, -1);
+            if (newIndex < 0) {
+                valid = false;
+            } else {
+                result->hits[h].index = newIndex;
+            }
+        }
+
+        if (valid && deltaCatalog->size() > 0) {
+            valid = evaluatePlan(*deltaCatalog, plan, showLatestSeason, false).hits.isEmpty();
+        }
+
+        if (valid) {
+            m_resultCache.insert(key, result);
+        } else {
+            delete result;
+        }
     }
-    return baseName.toLower();
 }
 
-// Helper: Check if weapon has a special suffix (Adept, Harrowed, Timelost, etc.)
-// This checks both the API field and the weapon name
-bool WeaponSearchModel::isAdeptWeapon(const QJsonObject &weapon) const
+// Empty query with the -h/-a/-e/-!/-* flags of a default view mask
+WeaponSearchModel::QueryPlan WeaponSearchModel::defaultViewPlan(int mask)
 {
-    // Check API's isAdept field first
-    if (weapon["isAdept"].toBool()) {
-        return true;
+    QueryPlan plan;
+    plan.holofoilOnly = mask & HolofoilFlag;
+    plan.adeptOnly = mask & AdeptFlag;
+    plan.exoticOnly = mask & ExoticFlag;
+    plan.uniqueByName = mask & UniqueFlag;
+    plan.noLimit = mask & NoLimitFlag;
+    return plan;
+}
+
+// Evaluate the empty query once per catalog for every combination of -h/-a/-e/-!/-* flags.
+// Runs on a worker pool so publishing a catalog never waits for it; lookups evaluate live until it lands.
+void WeaponSearchModel::buildDefaultViews()
+{
+    m_defaultViews.clear();
+    m_defaultViewsWatcher.cancel();
+
+    QVector<int> masks(DefaultViewCount);
+    for (int mask = 0; mask < DefaultViewCount; ++mask) {
+        masks[mask] = mask;
     }
-    
-    // Also check weapon name for (Adept), (Harrowed), (Timelost) suffixes
-    // This covers cases where API field might not be set for all variants
-    QString nameLower = weapon["name"].toString().toLower();
-    return nameLower.contains("(adept)") || 
-           nameLower.contains("(harrowed)") || 
-           nameLower.contains("(timelost)");
+
+    const WeaponCatalogPtr catalog = m_catalog;
+    m_defaultViewsCatalog = catalog;
+    m_defaultViewsWatcher.setFuture(QtConcurrent::mapped(&m_defaultViewsPool, std::move(masks), [this, catalog](int mask) {
+        // Views without -h/-a/-e/-* are latest-season lists; they are hidden at lookup when the toggle is off
+        return evaluatePlan(*catalog, defaultViewPlan(mask), true, false).hits;
+    }));
+}
+
+void WeaponSearchModel::onDefaultViewsBuilt()
+{
+    // Superseded by a newer catalog while it ran
+    if (m_defaultViewsWatcher.isCanceled() || m_defaultViewsCatalog != m_catalog) {
+        return;
+    }
+    const QList<QVector<SearchHit>> views = m_defaultViewsWatcher.future().results();
+    if (views.size() == DefaultViewCount) {
+        m_defaultViews = QVector<QVector<SearchHit>>(views.begin(), views.end());
+    }
+    m_defaultViewsCatalog.reset();
+}
+
+// Flag mask of a plan that is served by a default view, or -1 when it needs a real search
+int WeaponSearchModel::defaultViewMask(const QueryPlan &plan)
+{
+    if (!plan.queryLower.isEmpty() || !plan.sourceFilters.isEmpty()) {
+        return -1;
+    }
+    return (plan.holofoilOnly ? HolofoilFlag : 0)
+         | (plan.adeptOnly ? AdeptFlag : 0)
+         | (plan.exoticOnly ? ExoticFlag : 0)
+         | (plan.uniqueByName ? UniqueFlag : 0)
+         | (plan.noLimit ? NoLimitFlag : 0);
+}
+
+QVector<WeaponSearchModel::SearchHit> WeaponSearchModel::defaultView(int mask) const
+{
+    const bool isLatestSeasonView = (mask & ~UniqueFlag) == 0;
+    if (isLatestSeasonView && !m_showLatestSeason) {
+        return QVector<SearchHit>(); // Show nothing when not searching and showLatestSeason is false
+    }
+    if (m_defaultViews.isEmpty()) {
+        // Still building for this catalog
+        return evaluatePlan(*m_catalog, defaultViewPlan(mask), true, false).hits;
+    }
+    return m_defaultViews.value(mask);
 }
 
 void WeaponSearchModel::filterWeapons()
 {
+    SearchResult result;
+    if (m_searchQuery.trimmed().isEmpty()) {
+        // Opening the launcher or clearing the query: serve the ready-made list, no search work at all
+        result.hits = defaultView(0);
+    } else {
+        const QString key = cacheKey(m_searchQuery, m_showLatestSeason);
+        if (const SearchResult *cached = m_resultCache.object(key)) {
+            result = *cached;
+        } else {
+            QueryPlan plan = parseQuery(*m_catalog, m_searchQuery);
+            const int mask = defaultViewMask(plan);
+            if (mask >= 0) {
+                result.hits = defaultView(mask);
+            } else {
+                result = evaluatePlan(*m_catalog, plan, m_showLatestSeason, m_highlightMatches);
+            }
+            m_resultCache.insert(key, new SearchResult(result));
+        }
+    }
+
     beginResetModel();
+    m_results = result.hits;
+    endResetModel();
+    
+    // Start the first screen of icons before the delegates exist
+    emit iconsWanted(iconPaths(0, PREFETCH_ICON_ROWS));
+
+    // Update active source filters for QML
+    if (m_activeSourceFilters != result.activeSourceFilters) {
+        m_activeSourceFilters = result.activeSourceFilters;
+        emit activeSourceFiltersChanged();
+    }
+}
+
+// Runs on the GUI thread for typed queries and on worker threads for predicted or batched ones,
+// so everything below must only read from the catalog snapshot it is given
+WeaponSearchModel::SearchResult WeaponSearchModel::computeResults(const WeaponCatalog &catalog, const QString &query, bool showLatestSeason, bool highlightMatches) const
+{
+    return evaluatePlan(catalog, parseQuery(catalog, query), showLatestSeason, highlightMatches);
+}
+
+WeaponSearchModel::QueryPlan WeaponSearchModel::parseQuery(const WeaponCatalog &catalog, const QString &query) const
+{
+    QueryPlan plan;
 
     // Parse special flags first: -! (unique by name), -* (no limit), -h (holofoil only), -a (adept only), -e (exotic only)
-    bool uniqueByName = false;    // -! flag: show only one weapon per name (prefer non-holofoil, non-adept)
-    bool noLimit = false;         // -* flag: remove result limit
-    bool holofoilOnly = false;    // -h flag or "holofoil"/"holo" keyword: show only holofoil weapons
-    bool adeptOnly = false;       // -a flag or "adept" keyword: show only adept/harrowed/timelost weapons
-    bool exoticOnly = false;      // -e flag or "exotic" keyword: show only exotic weapons
-    QStringList sourceFilters;    // -s flag: filter by source (e.g., -s gambit, -s vog)
-    
-    QString queryLower = m_searchQuery.toLower().trimmed();
+    // -s flag: filter by source (e.g., -s gambit, -s vog)
+    QString queryLower = query.toLower().trimmed();
     
     // Parse -s source filters first (e.g., "-s gambit", "-s vog", "-s trials")
     // Can have multiple: "-s gambit -s trials"
@@ -172,8 +377,8 @@ void WeaponSearchModel::filterWeapons()
     while (sourceMatches.hasNext()) {
         QRegularExpressionMatch match = sourceMatches.next();
         QString sourceAlias = match.captured(1).toLower();
-        if (!sourceFilters.contains(sourceAlias)) {
-            sourceFilters.append(sourceAlias);
+        if (!plan.sourceFilters.contains(sourceAlias)) {
+            plan.sourceFilters.append(sourceAlias);
         }
     }
     // Remove source patterns from query
@@ -190,19 +395,19 @@ void WeaponSearchModel::filterWeapons()
         QRegularExpressionMatch match = flagMatches.next();
         QString flags = match.captured(1);
         if (flags.contains('!')) {
-            uniqueByName = true;
+            plan.uniqueByName = true;
         }
         if (flags.contains('*')) {
-            noLimit = true;
+            plan.noLimit = true;
         }
         if (flags.contains('h')) {
-            holofoilOnly = true;
+            plan.holofoilOnly = true;
         }
         if (flags.contains('a')) {
-            adeptOnly = true;
+            plan.adeptOnly = true;
         }
         if (flags.contains('e')) {
-            exoticOnly = true;
+            plan.exoticOnly = true;
         }
     }
     
@@ -213,48 +418,43 @@ void WeaponSearchModel::filterWeapons()
     
     // Check for "holofoil" or "holo" keyword
     if (queryLower.contains("holofoil")) {
-        holofoilOnly = true;
+        plan.holofoilOnly = true;
         queryLower = queryLower.replace("holofoil", "").trimmed();
     } else if (queryLower.contains("holo")) {
-        holofoilOnly = true;
+        plan.holofoilOnly = true;
         queryLower = queryLower.replace("holo", "").trimmed();
     }
     
     // Check for "adept" keyword
     if (queryLower == "adept" || queryLower.startsWith("adept ") || queryLower.endsWith(" adept") || queryLower.contains(" adept ")) {
-        adeptOnly = true;
+        plan.adeptOnly = true;
         queryLower = queryLower.replace(QRegularExpression("\\badept\\b"), "").trimmed();
     }
     
     // Check for "exotic" keyword
     if (queryLower == "exotic" || queryLower.startsWith("exotic ") || queryLower.endsWith(" exotic") || queryLower.contains(" exotic ")) {
-        exoticOnly = true;
+        plan.exoticOnly = true;
         queryLower = queryLower.replace(QRegularExpression("\\bexotic\\b"), "").trimmed();
     }
     
     // Build a map of source aliases to display names for active filters
     // We need to scan weapons to find matching sourceDisplayNames
     // Priority: exact match > starts-with match > contains match
-    QStringList matchedSourceDisplayNames;
-    if (!sourceFilters.isEmpty()) {
+    if (!plan.sourceFilters.isEmpty()) {
         // For each filter, find the best matching source(s)
         // Exact match = only that source, starts-with/contains = all matching sources
-        for (const QString &filterAlias : sourceFilters) {
+        for (const QString &filterAlias : plan.sourceFilters) {
             std::set<QString> exactMatches;
             std::set<QString> startsWithMatches;
             std::set<QString> containsMatches;
             
-            for (const QJsonValue &value : m_allWeapons) {
-                QJsonObject weapon = value.toObject();
-                QJsonArray aliases = weapon["sourceSearchAliases"].toArray();
-                QString displayName = weapon["sourceDisplayName"].toString();
+            for (const WeaponRecord &weapon : catalog.weapons()) {
+                const QString &displayName = weapon.sourceDisplayName;
                 
                 if (displayName.isEmpty()) continue;
                 
-                for (const QJsonValue &aliasVal : aliases) {
-                    QString alias = aliasVal.toString().toLower();
-                    
-                    // Check for exact match first (highest priority)
+                for (const QString &alias : weapon.sourceSearchAliases) {
+                    // Check for exactmatch first (highest priority)
                     if (alias == filterAlias) {
                         exactMatches.insert(displayName);
                         break;
@@ -282,112 +482,218 @@ void WeaponSearchModel::filterWeapons()
             
             if (bestMatches) {
                 for (const QString &displayName : *bestMatches) {
-                    if (!matchedSourceDisplayNames.contains(displayName)) {
-                        matchedSourceDisplayNames.append(displayName);
+                    if (!plan.matchedSourceDisplayNames.contains(displayName)) {
+                        plan.matchedSourceDisplayNames.append(displayName);
                     }
                 }
             }
         }
     }
     
-    // Update active source filters for QML
-    if (m_activeSourceFilters != matchedSourceDisplayNames) {
-        m_activeSourceFilters = matchedSourceDisplayNames;
-        emit activeSourceFiltersChanged();
+    // Check if query is a season-specific search like "Season 28" or "s28"
+    // Check for "Season X" or "Season of..." pattern
+    QRegularExpression seasonPattern("^season\\s*(\\d+)$", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch seasonMatch = seasonPattern.match(queryLower);
+    if (seasonMatch.hasMatch()) {
+        plan.isSeasonSearch = true;
+        plan.searchedSeasonNum = seasonMatch.captured(1).toInt();
     }
-    
-    // Helper lambda to check if a weapon matches the source filters
-    // Uses the same priority logic: exact > starts-with > contains
-    auto matchesSourceFilter = [&sourceFilters, &matchedSourceDisplayNames](const QJsonObject &weapon) -> bool {
-        if (sourceFilters.isEmpty()) return true;
-        
-        // If we found specific sources, only match those
-        QString weaponSource = weapon["sourceDisplayName"].toString();
-        if (!matchedSourceDisplayNames.isEmpty()) {
-            return matchedSourceDisplayNames.contains(weaponSource);
-        }
-        
-        // Fallback to alias matching
-        QJsonArray aliases = weapon["sourceSearchAliases"].toArray();
-        for (const QString &filterAlias : sourceFilters) {
-            bool found = false;
-            for (const QJsonValue &aliasVal : aliases) {
-                QString alias = aliasVal.toString().toLower();
-                if (alias == filterAlias || alias.contains(filterAlias) || filterAlias.contains(alias)) {
-                    found = true;
-                    break;
-                }
+
+    // Check for "sX" pattern (e.g., "s28")
+    QRegularExpression sPattern("^s(\\d+)$", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatch sMatch = sPattern.match(queryLower);
+    if (sMatch.hasMatch()) {
+        plan.isSeasonSearch = true;
+        plan.searchedSeasonNum = sMatch.captured(1).toInt();
+    }
+
+    // Split query into terms for normal search
+    plan.queryLower = queryLower;
+    plan.searchTerms = queryLower.split(' ', Qt::SkipEmptyParts);
+
+    return plan;
+}
+
+// Check if a weapon matches the source filters
+// Uses the same priority logic: exact > starts-with > contains
+bool WeaponSearchModel::matchesSourceFilter(const QueryPlan &plan, const WeaponRecord &weapon) const
+{
+    if (plan.sourceFilters.isEmpty()) return true;
+
+    // If we found specific sources, only match those
+    if (!plan.matchedSourceDisplayNames.isEmpty()) {
+        return plan.matchedSourceDisplayNames.contains(weapon.sourceDisplayName);
+    }
+
+    // Fallback to alias matching
+    for (const QString &filterAlias : plan.sourceFilters) {
+        bool found = false;
+        for (const QString &alias : weapon.sourceSearchAliases) {
+            if (alias == filterAlias ||alias.contains(filterAlias) || filterAlias.contains(alias)) {
+                found = true;
+                break;
             }
-            if (!found) return false; // All filters must match
         }
-        return true;
-    };
+        if (!found) return false; // All filters must match
+    }
+    return true;
+}
+
+// Score a single search term against one weapon's fields and report which field won
+WeaponSearchModel::TermMatch WeaponSearchModel::scoreTerm(const WeaponCatalog::SearchFields &fields, const QString &term, QVector<int> *nameSpans) const
+{
+    int termScore = 0;
+    MatchField termMatchedField = NoField;
+
+    // Priority order (highest to lowest):
+    // 1. Name (weapon name) - 1.0x + 1000 bonus (highest priority)
+    // 2. Weapon type - 0.9x
+    // 3. Frame type - 0.8x
+    // 4. Season number ("Season X" format) - 0.6x
+    // 5. Season name/display - 0.5x (lowest priority)
+
+    // Check season name first (lowest priority - 0.5x multiplier)
+    int seasonNameScore = fuzzyScore(fields.seasonName, term);
+    if (seasonNameScore > 0) {
+        termScore = static_cast<int>(seasonNameScore * 0.5);
+        termMatchedField = SeasonNameField;
+    }
+
+    // Check seasonDisplay (full display name like "Lightfall • Season of Defiance")
+    int seasonDisplayScore = fuzzyScore(fields.seasonDisplay, term);
+    if (seasonDisplayScore > 0 && static_cast<int>(seasonDisplayScore * 0.5) > termScore) {
+        termScore = static_cast<int>(seasonDisplayScore * 0.5);
+        termMatchedField = SeasonNameField;
+    }
+
+    // Check season ("Season X" format) - higher than seasonName (0.6x)
+    int seasonScore = fuzzyScore(fields.season, term);
+    if (seasonScore > 0 && static_cast<int>(seasonScore * 0.6) > termScore) {
+        termScore = static_cast<int>(seasonScore * 0.6);
+        termMatchedField = SeasonNumberField;
+    }
+
+    // Check season number exact match (bonus for exact "28" or "s28")
+    if (fields.seasonNumber == term || term == "s" + fields.seasonNumber) {
+        int exactSeasonScore = static_cast<int>(700 * 0.6);
+        if (exactSeasonScore > termScore) {
+            termScore = exactSeasonScore;
+            termMatchedField = SeasonNumberField;
+        }
+    }
+
+    // Check frame type (0.8x multiplier)
+    int frameTypeScore = fuzzyScore(fields.frameType, term);
+    if (frameTypeScore > 0 && static_cast<int>(frameTypeScore * 0.8) > termScore) {
+        termScore = static_cast<int>(frameTypeScore * 0.8);
+        termMatchedField = FrameTypeField;
+    }
+
+    // Check weapon type (0.9x multiplier)
+    int weaponTypeScore = fuzzyScore(fields.weaponType, term);
+    if (weaponTypeScore > 0 && static_cast<int>(weaponTypeScore * 0.9) > termScore) {
+        termScore = static_cast<int>(weaponTypeScore * 0.9);
+        termMatchedField = WeaponTypeField;
+    }
+
+    // Check name (highest priority - 1.0x + 1000 bonus)
+    // Scored on the original name (normalization lowercases anyway) so spans index the displayed text
+    int nameScore = fuzzyScore(fields.name, term, nameSpans);
+    if (nameScore > 0 && (nameScore + 1000) > termScore) {
+        termScore = nameScore + 1000;
+        termMatchedField = NameField;
+    }
+
+    TermMatch match;
+    match.score = static_cast<qint16>(termScore);
+    match.field = termMatchedField;
+    return match;
+}
+
+QString WeaponSearchModel::matchFieldName(MatchField field)
+{
+    switch (field) {
+    case NameField:
+        return QStringLiteral("name");
+    case WeaponTypeField:
+        return QStringLiteral("weaponType");
+    case FrameTypeField:
+        return QStringLiteral("frameType");
+    case SeasonNumberField:
+        return QStringLiteral("seasonNumber");
+    case SeasonNameField:
+        return QStringLiteral("seasonName");
+    default:
+        return QString();
+    }
+}
+
+WeaponSearchModel::SearchResult WeaponSearchModel::evaluatePlan(const WeaponCatalog &catalog, const QueryPlan &plan, bool showLatestSeason, bool highlightMatches) const
+{
+    const int latestSeason = catalog.latestSeason();
+    SearchResult result;
+
+    // Active source filters are published to QML by the caller
+    result.activeSourceFilters = plan.matchedSourceDisplayNames;
 
     // If query is empty (after removing flags), show latest season weapons with filters applied
     // The -* flag allows showing ALL weapons (not just latest season)
     // Filter flags (-h, -a, -e) when used alone should search ALL weapons
     // -! (unique) alone still shows latest season only
-    bool hasFilterFlags = holofoilOnly || adeptOnly || exoticOnly;
-    bool showAllWeapons = noLimit || !sourceFilters.isEmpty() || hasFilterFlags; // -* flag, -s flag, or filter flags shows all weapons
+    bool hasFilterFlags = plan.holofoilOnly || plan.adeptOnly || plan.exoticOnly;
+    bool showAllWeapons = plan.noLimit || !plan.sourceFilters.isEmpty() || hasFilterFlags; // -* flag, -s flag, or filter flags shows all weapons
     
-    if (queryLower.isEmpty() && !showAllWeapons) {
-        if (!m_showLatestSeason) {
-            // Show nothing when not searching and showLatestSeason is false
-            m_filteredWeapons = QJsonArray();
-        } else {
+    if (plan.queryLower.isEmpty() && !showAllWeapons) {
+        if (showLatestSeason) {
             // Show only latest season weapons, sorted alphabetically by name
-            QList<QPair<QString, QJsonValue>> latestSeasonWeapons;
-            std::set<std::string> seenWeaponNames;
+            QVector<quint64> latestSeasonWeapons;  // name rank << 32 | catalog index
+            std::set<QString> seenWeaponNames;
             
-            for (const QJsonValue &value : m_allWeapons) {
-                QJsonObject weapon = value.toObject();
-                int seasonNum = weapon["seasonNumber"].toInt();
+            for (int i = 0; i < catalog.size(); ++i) {
+                const WeaponCatalog::SearchFields &fields = catalog.searchFields(i);
                 
-                if (seasonNum == m_latestSeason) {
-                    QString name = weapon["name"].toString();
-                    bool isHolofoil = weapon["isHolofoil"].toBool();
-                    bool isExotic = weapon["isExotic"].toBool();
-                    bool isAdept = isAdeptWeapon(weapon);
+                if (fields.seasonNum == latestSeason) {
+                    bool isHolofoil = catalog.isHolofoil(i);
+                    bool isExotic = catalog.isExotic(i);
+                    bool isAdept = catalog.isAdept(i);
                     
                     // Apply holofoil filter
-                    if (holofoilOnly && !isHolofoil) {
+                    if (plan.holofoilOnly && !isHolofoil) {
                         continue; // Skip non-holofoil weapons when holofoil filter is active
                     }
                     
                     // Apply exotic filter
-                    if (exoticOnly && !isExotic) {
+                    if (plan.exoticOnly && !isExotic) {
                         continue; // Skip non-exotic weapons when exotic filter is active
                     }
                     
                     // Apply adept filter
-                    if (adeptOnly && !isAdept) {
+                    if (plan.adeptOnly && !isAdept) {
                         continue; // Skip non-adept weapons when adept filter is active
                     }
                     
                     // If uniqueByName is enabled, skip if we've seen this base name
                     // When holofoilOnly is active, we keep holofoil versions
                     // When not holofoilOnly, prefer non-holofoil, non-adept versions
-                    if (uniqueByName) {
+                    if (plan.uniqueByName) {
                         // Use base name (without Adept/Harrowed/Timelost suffix) for comparison
-                        std::string nameKey = getBaseWeaponName(name).toStdString();
-                        if (seenWeaponNames.count(nameKey) > 0) {
+                        if (seenWeaponNames.count(fields.baseName) > 0) {
                             continue;
                         }
                         
                         // If holofoilOnly is active, we're already filtering to holofoil only
                         // So just add this weapon (first holofoil with this base name)
                         // Same for adeptOnly - just add the first matching weapon
-                        if (!holofoilOnly && !adeptOnly) {
+                        if (!plan.holofoilOnly && !plan.adeptOnly) {
                             // If this is holofoil or adept, check if a base version exists
                             if (isHolofoil || isAdept) {
                                 bool hasBaseVersion = false;
-                                for (const QJsonValue &other : m_allWeapons) {
-                                    QJsonObject otherWeapon = other.toObject();
-                                    QString otherName = otherWeapon["name"].toString();
-                                    if (otherWeapon["seasonNumber"].toInt() == m_latestSeason &&
-                                        getBaseWeaponName(otherName) == getBaseWeaponName(name) &&
-                                        !otherWeapon["isHolofoil"].toBool() &&
-                                        !isAdeptWeapon(otherWeapon)) {
+                                for (int j = 0; j < catalog.size(); ++j) {
+                                    const WeaponCatalog::SearchFields &other = catalog.searchFields(j);
+                                    if (other.seasonNum == latestSeason &&
+                                        other.baseName == fields.baseName &&
+                                        !catalog.isHolofoil(j) &&
+                                        !catalog.isAdept(j)) {
                                         hasBaseVersion = true;
                                         break;
                                     }
@@ -397,107 +703,69 @@ void WeaponSearchModel::filterWeapons()
                                 }
                             }
                         }
-                        seenWeaponNames.insert(nameKey);
+                        seenWeaponNames.insert(fields.baseName);
                     }
                     
-                    latestSeasonWeapons.append({name, value});
+                    latestSeasonWeapons.append((static_cast<quint64>(catalog.nameRank(i)) << 32) | static_cast<quint64>(i));
                 }
             }
             
             // Sort alphabetically by name
-            std::sort(latestSeasonWeapons.begin(), latestSeasonWeapons.end(),
-                      [](const auto &a, const auto &b) { return a.first.toLower() < b.first.toLower(); });
-            
-            m_filteredWeapons = QJsonArray();
-            for (const auto &pair : latestSeasonWeapons) {
-                m_filteredWeapons.append(pair.second);
+            std::sort(latestSeasonWeapons.begin(), latestSeasonWeapons.end());
+
+            result.hits.reserve(latestSeasonWeapons.size());
+            for (quint64 entry : latestSeasonWeapons) {
+                result.hits.append(SearchHit{static_cast<int>(entry & 0xffffffff), QString(), {}});
             }
         }
+        // Otherwise show nothing when not searching and showLatestSeason is false
     } else {
         // Search mode: support multi-term search (e.g., "pulse micro-missile")
         // Each term must match at least one field
-        QList<std::tuple<int, int, QString, QJsonObject>> scoredWeapons; // score, seasonNumber, name, weapon with matchedFields
-        
-        // First, check if query is a season-specific search like "Season 28" or "s28"
-        bool isSeasonSearch = false;
-        int searchedSeasonNum = -1;
-        
-        // Check for "Season X" or "Season of..." pattern
-        QRegularExpression seasonPattern("^season\\s*(\\d+)$", QRegularExpression::CaseInsensitiveOption);
-        QRegularExpressionMatch seasonMatch = seasonPattern.match(queryLower);
-        if (seasonMatch.hasMatch()) {
-            isSeasonSearch = true;
-            searchedSeasonNum = seasonMatch.captured(1).toInt();
-        }
-        
-        // Check for "sX" pattern (e.g., "s28")
-        QRegularExpression sPattern("^s(\\d+)$", QRegularExpression::CaseInsensitiveOption);
-        QRegularExpressionMatch sMatch = sPattern.match(queryLower);
-        if (sMatch.hasMatch()) {
-            isSeasonSearch = true;
-            searchedSeasonNum = sMatch.captured(1).toInt();
-        }
-        
-        // Split query into terms for normal search
-        QStringList searchTerms = queryLower.split(' ', Qt::SkipEmptyParts);
-        
-        // Track seen weapon base names for uniqueByName filter
-        std::set<QString> seenWeaponNames;
-        
-        for (const QJsonValue &value : m_allWeapons) {
-            QJsonObject weapon = value.toObject();
-            bool isHolofoil = weapon["isHolofoil"].toBool();
-            bool isExotic = weapon["isExotic"].toBool();
-            QString weaponName = weapon["name"].toString();
-            bool isAdept = isAdeptWeapon(weapon);
-            QString baseName = getBaseWeaponName(weaponName);
-            
+        QVector<SearchHit> candidates;
+        QVector<QPair<quint64, int>> scoredWeapons; // ranking key, position in candidates
+
+        for (int i = 0; i < catalog.size(); ++i) {
             // Apply holofoil filter
-            if (holofoilOnly && !isHolofoil) {
+            if (plan.holofoilOnly && !catalog.isHolofoil(i)) {
                 continue; // Skip non-holofoil weapons when holofoil filter is active
             }
             
             // Apply exotic filter
-            if (exoticOnly && !isExotic) {
+            if (plan.exoticOnly && !catalog.isExotic(i)) {
                 continue; // Skip non-exotic weapons when exotic filter is active
             }
             
             // Apply adept filter
-            if (adeptOnly && !isAdept) {
+            if (plan.adeptOnly && !catalog.isAdept(i)) {
                 continue; // Skip non-adept weapons when adept filter is active
             }
             
             // Apply source filter
-            if (!matchesSourceFilter(weapon)) {
+            if (!plan.sourceFilters.isEmpty() && !matchesSourceFilter(plan, catalog.weapon(i))) {
                 continue; // Skip weapons that don't match source filter
             }
             
             // Note: uniqueByName filter is applied AFTER sorting to prefer newer season weapons
             // See the result collection loop below
             
-            QString name = weaponName.toLower();
-            QString weaponType = weapon["weaponType"].toString().toLower();
-            QString frameType = weapon["frameType"].toString().toLower();
-            QString seasonName = weapon["seasonName"].toString().toLower();
-            QString season = weapon["season"].toString().toLower(); // "Season X" format
-            QString seasonDisplay = weapon["seasonDisplay"].toString().toLower(); // Full display name
-            int seasonNum = weapon["seasonNumber"].toInt();
-            QString seasonNumStr = QString::number(seasonNum);
+            const WeaponCatalog::SearchFields &fields = catalog.searchFields(i);
+            int seasonNum = fields.seasonNum;
             
             // If this is a specific season search, only include weapons from that season
-            if (isSeasonSearch) {
-                if (seasonNum == searchedSeasonNum) {
-                    weapon["matchedField"] = "seasonNumber";
+            if (plan.isSeasonSearch) {
+                if (seasonNum == plan.searchedSeasonNum) {
                     // Sort by name alphabetically within the season
-                    scoredWeapons.append({1000, seasonNum, name, weapon});
+                    scoredWeapons.append({rankingKey(1000, seasonNum, catalog.nameRank(i)), static_cast<int>(candidates.size())});
+                    candidates.append(SearchHit{i, "seasonNumber", {}});
                 }
                 continue; // Skip normal term matching for season-specific searches
             }
             
             // If only flags were provided (no search terms), show all weapons
-            if (searchTerms.isEmpty()) {
-                weapon["matchedField"] = "";
-                scoredWeapons.append({500, seasonNum, name, weapon});
+            if (plan.searchTerms.isEmpty()) {
+                scoredWeapons.append({rankingKey(500, seasonNum, catalog.nameRank(i)), static_cast<int>(candidates.size())});
+                candidates.append(SearchHit{i, QString(), {}});
                 continue;
             }
             
@@ -505,116 +773,46 @@ void WeaponSearchModel::filterWeapons()
             bool allTermsMatch = true;
             int totalScore = 0;
             QStringList matchedFields;
+            QVector<int> matchSpans;
+            QVector<int> termSpans;
             
-            for (const QString &term : searchTerms) {
-                int termScore = 0;
-                QString termMatchedField = "";
-                
-                // Priority order (highest to lowest):
-                // 1. Name (weapon name) - 1.0x + 1000 bonus (highest priority)
-                // 2. Weapon type - 0.9x
-                // 3. Frame type - 0.8x
-                // 4. Season number ("Season X" format) - 0.6x
-                // 5. Season name/display - 0.5x (lowest priority)
+            for (int t = 0; t < plan.searchTerms.size(); ++t) {
+                // Batch evaluation hands in scores shared by every query using the same term
+                const TermMatch match = plan.termScores.isEmpty()
+                    ? scoreTerm(fields, plan.searchTerms[t], highlightMatches ? &termSpans : nullptr)
+                    : plan.termScores[t]->at(i);
                 
-                // Check season name first (lowest priority - 0.5x multiplier)
-                int seasonNameScore = fuzzyScore(seasonName, term);
-                if (seasonNameScore > 0) {
-                    termScore = static_cast<int>(seasonNameScore * 0.5);
-                    termMatchedField = "seasonName";
-                }
-                
-                // Check seasonDisplay (full display name like "Lightfall • Season of Defiance")
-                int seasonDisplayScore = fuzzyScore(seasonDisplay, term);
-                if (seasonDisplayScore > 0 && static_cast<int>(seasonDisplayScore * 0.5) > termScore) {
-                    termScore = static_cast<int>(seasonDisplayScore * 0.5);
-                    termMatchedField = "seasonName";
-                }
-                
-                // Check season ("Season X" format) - higher than seasonName (0.6x)
-                int seasonScore = fuzzyScore(season, term);
-                if (seasonScore > 0 && static_cast<int>(seasonScore * 0.6) > termScore) {
-                    termScore = static_cast<int>(seasonScore * 0.6);
-                    termMatchedField = "seasonNumber";
-                }
-                
-                // Check season number exact match (bonus for exact "28" or "s28")
-                if (seasonNumStr == term || term == "s" + seasonNumStr) {
-                    int exactSeasonScore = static_cast<int>(700 * 0.6);
-                    if (exactSeasonScore > termScore) {
-                        termScore = exactSeasonScore;
-                        termMatchedField = "seasonNumber";
-                    }
-                }
-                
-                // Check frame type (0.8x multiplier)
-                int frameTypeScore = fuzzyScore(frameType, term);
-                if (frameTypeScore > 0 && static_cast<int>(frameTypeScore * 0.8) > termScore) {
-                    termScore = static_cast<int>(frameTypeScore * 0.8);
-                    termMatchedField = "frameType";
-                }
-                
-                // Check weapon type (0.9x multiplier)
-                int weaponTypeScore = fuzzyScore(weaponType, term);
-                if (weaponTypeScore > 0 && static_cast<int>(weaponTypeScore * 0.9) > termScore) {
-                    termScore = static_cast<int>(weaponTypeScore * 0.9);
-                    termMatchedField = "weaponType";
-                }
-                
-                // Check name (highest priority - 1.0x + 1000 bonus)
-                int nameScore = fuzzyScore(name, term);
-                if (nameScore > 0 && (nameScore + 1000) > termScore) {
-                    termScore = nameScore + 1000;
-                    termMatchedField = "name";
-                }
-                
-                if (termScore == 0) {
+                if (match.score == 0) {
                     allTermsMatch = false;
                     break;
                 }
                 
-                totalScore += termScore;
-                if (!termMatchedField.isEmpty() && termMatchedField != "name" && !matchedFields.contains(termMatchedField)) {
-                    matchedFields.append(termMatchedField);
+                totalScore += match.score;
+                if (match.field == NameField) {
+                    matchSpans += termSpans;
+                } else if (match.field != NoField && !matchedFields.contains(matchFieldName(match.field))) {
+                    matchedFields.append(matchFieldName(match.field));
                 }
             }
             
             if (allTermsMatch && totalScore > 0) {
-                // Store matched fields as comma-separated string
-                weapon["matchedField"] = matchedFields.join(",");
-                
                 // Add season bonus: newer seasons get higher score
                 // This ensures that among similar name matches, newer season weapons rank higher
                 // Season bonus: seasonNum * 10 (e.g., S28 = +280, S24 = +240, difference = 40 points)
                 int seasonBonus = seasonNum * 10;
                 int finalScore = totalScore + seasonBonus;
                 
-                scoredWeapons.append({finalScore, seasonNum, name, weapon});
+                // Store matched fields as comma-separated string
+                mergeMatchSpans(matchSpans);
+                scoredWeapons.append({rankingKey(finalScore, seasonNum, catalog.nameRank(i)), static_cast<int>(candidates.size())});
+                candidates.append(SearchHit{i, matchedFields.join(","), matchSpans});
             }
         }
 
         // Sort by: score (descending), then season (descending), then alphabetically
         // Since season bonus is already included in score, this naturally prioritizes newer seasons
-        std::sort(scoredWeapons.begin(), scoredWeapons.end(),
-                  [](const auto &a, const auto &b) {
-                      int scoreA = std::get<0>(a);
-                      int scoreB = std::get<0>(b);
-                      
-                      // Primary: sort by score (higher first)
-                      if (scoreA != scoreB) {
-                          return scoreA > scoreB;
-                      }
-                      
-                      // Secondary: sort by season number (higher/newer first)
-                      int seasonA = std::get<1>(a);
-                      int seasonB = std::get<1>(b);
-                      if (seasonA != seasonB) {
-                          return seasonA > seasonB;
-                      }
-                      
-                      // Tertiary: sort alphabetically by name
-                      return std::get<2>(a).toLower() < std::get<2>(b).toLower();
-                  });
+        // All three criteria are packed into the key, so this is a plain integer sort
+        std::sort(scoredWeapons.begin(), scoredWeapons.end());
 
         // Determine result limit:
         // - noLimit flag (-*): no limit
@@ -622,8 +820,7 @@ void WeaponSearchModel::filterWeapons()
         // - sourceFilters active (-s gambit): no limit
         // - holofoilOnly, uniqueByName, adeptOnly, or exoticOnly with no other search: no limit
         // - Otherwise: limit to 50
-        m_filteredWeapons = QJsonArray();
-        bool shouldRemoveLimit = noLimit || isSeasonSearch || !sourceFilters.isEmpty() || ((holofoilOnly || uniqueByName || adeptOnly || exoticOnly) && searchTerms.isEmpty());
+        bool shouldRemoveLimit = plan.noLimit || plan.isSeasonSearch || !plan.sourceFilters.isEmpty() || ((plan.holofoilOnly || plan.uniqueByName || plan.adeptOnly || plan.exoticOnly) && plan.searchTerms.isEmpty());
         int maxResults = shouldRemoveLimit ? scoredWeapons.size() : qMin(50, static_cast<int>(scoredWeapons.size()));
         
         // Apply uniqueByName filter AFTER sorting - this ensures newer season weapons are preferred
@@ -632,15 +829,14 @@ void WeaponSearchModel::filterWeapons()
         std::set<QString> seenUniqueNames;
         
         for (int i = 0; i < scoredWeapons.size(); ++i) {
-            if (!uniqueByName && static_cast<int>(m_filteredWeapons.size()) >= maxResults) {
+            if (!plan.uniqueByName && static_cast<int>(result.hits.size()) >= maxResults) {
                 break;
             }
             
-            QJsonObject weapon = std::get<3>(scoredWeapons[i]);
+            const SearchHit &hit = candidates[scoredWeapons[i].second];
             
-            if (uniqueByName) {
-                QString weaponName = weapon["name"].toString();
-                QString baseName = getBaseWeaponName(weaponName);
+            if (plan.uniqueByName) {
+                const QString &baseName = catalog.searchFields(hit.index).baseName;
                 
                 // Skip if we've already seen this base weapon name
                 if (seenUniqueNames.find(baseName) != seenUniqueNames.end()) {
@@ -649,11 +845,188 @@ void WeaponSearchModel::filterWeapons()
                 seenUniqueNames.insert(baseName);
             }
             
-            m_filteredWeapons.append(weapon);
+            result.hits.append(hit);
         }
     }
 
-    endResetModel();
+    return result;
+}
+
+// Bytes held by a result list: the hits plus their matched-field text and highlight spans
+qint64 WeaponSearchModel::hitsBytes(const QVector<SearchHit> &hits, QSet<const void *> &seen)
+{
+    qint64 bytes = qint64(hits.capacity()) * qint64(sizeof(SearchHit));
+    for (const SearchHit &hit : hits) {
+        bytes += WeaponCatalog::stringBytes(hit.matchedField, seen);
+        bytes += qint64(hit.matchSpans.capacity()) * qint64(sizeof(int));
+    }
+    return bytes;
+}
+
+QVariantMap WeaponSearchModel::memoryStats() const
+{
+    const WeaponCatalog::MemoryUsage catalogUsage = m_catalog->memoryUsage();
+    QSet<const void *> seen;
+
+    qint64 resultCacheBytes = 0;
+    const QList<QString> keys = m_resultCache.keys();
+    for (const QString &key : keys) {
+        resultCacheBytes += WeaponCatalog::stringBytes(key, seen);
+        if (const SearchResult *result = m_resultCache.object(key)) {
+            resultCacheBytes += hitsBytes(result->hits, seen);
+        }
+    }
+
+    qint64 defaultViewBytes = 0;
+    for (const QVector<SearchHit> &view : m_defaultViews) {
+        defaultViewBytes += hitsBytes(view, seen);
+    }
+
+    QVariantMap stats;
+    stats["weapons"] = m_catalog->size();
+    stats["catalog"] = catalogUsage.records;
+    stats["index"] = catalogUsage.index;
+    stats["resultCache"] = resultCacheBytes;
+    stats["resultCacheEntries"] = keys.size();
+    stats["defaultViews"] = defaultViewBytes;
+    stats["results"] = hitsBytes(m_results, seen);
+    return stats;
+}
+
+void WeaponSearchModel::logMemoryStats() const
+{
+    const QVariantMap stats = memoryStats();
+    qDebug() << "Memory:" << stats["weapons"].toInt() << "weapons,"
+             << "catalog" << stats["catalog"].toLongLong() / 1024 << "KB,"
+             << "index" << stats["index"].toLongLong() / 1024 << "KB,"
+             << "result cache" << stats["resultCache"].toLongLong() / 1024 << "KB"
+             << "(" << stats["resultCacheEntries"].toInt() << "entries),"
+             << "default views" << stats["defaultViews"].toLongLong() / 1024 << "KB,"
+             << "results" << stats["results"].toLongLong() / 1024 << "KB";
+}
+
+QVariantList WeaponSearchModel::evaluateQueries(const QStringList &queries) const
+{
+    const WeaponCatalogPtr catalog = m_catalog;
+    const bool showLatestSeason = m_showLatestSeason;
+
+    // Plan every query up front so terms shared between queries are scored only once
+    QList<QueryPlan> plans = QtConcurrent::blockingMapped<QList<QueryPlan>>(queries, [this, catalog](const QString &query) {
+        return parseQuery(*catalog, query);
+    });
+
+    QStringList uniqueTerms;
+    QSet<QString> seenTerms;
+    for (const QueryPlan &plan : plans) {
+        if (plan.isSeasonSearch) continue;
+        for (const QString &term : plan.searchTerms) {
+            if (!seenTerms.contains(term)) {
+                seenTerms.insert(term);
+                uniqueTerms.append(term);
+            }
+        }
+    }
+
+    // Interned term scores: one column of (score, field) per distinct term across the whole catalog
+    const QList<QVector<TermMatch>> termColumns = QtConcurrent::blockingMapped<QList<QVector<TermMatch>>>(uniqueTerms, [this, catalog](const QString &term) {
+        QVector<TermMatch> column(catalog->size());
+        for (int i = 0; i < catalog->size(); ++i) {
+            column[i] = scoreTerm(catalog->searchFields(i), term, nullptr);
+        }
+        return column;
+    });
+
+    QHash<QString, const QVector<TermMatch> *> columnByTerm;
+    for (int i = 0; i < uniqueTerms.size(); ++i) {
+        columnByTerm.insert(uniqueTerms[i], &termColumns[i]);
+    }
+    for (QueryPlan &plan : plans) {
+        if (plan.isSeasonSearch) continue;
+        for (const QString &term : plan.searchTerms) {
+            plan.termScores.append(columnByTerm.value(term));
+        }
+    }
+
+    // Ranking only reads the shared snapshot and columns, so queries spread freely across cores
+    const QList<QVariantList> ranked = QtConcurrent::blockingMapped<QList<QVariantList>>(plans, [this, catalog, showLatestSeason](const QueryPlan &plan) {
+        QVariantList hashes;
+        const SearchResult result = evaluatePlan(*catalog, plan, showLatestSeason, false);
+        hashes.reserve(result.hits.size());
+        for (const SearchHit &hit : result.hits) {
+            hashes.append(catalog->weapon(hit.index).hash);
+        }
+        return hashes;
+    });
+
+    QVariantList results;
+    results.reserve(ranked.size());
+    for (const QVariantList &hashes : ranked) {
+        results.append(QVariant(hashes));
+    }
+    return results;
+}
+
+// Predict what the user is likely to type next: the current query extended by the
+// characters that most often continue the last term in the vocabulary, plus backspace
+QStringList WeaponSearchModel::predictNextQueries(const QString &query) const
+{
+    QStringList candidates;
+    const QString queryLower = query.toLower();
+    const QString lastTerm = queryLower.mid(queryLower.lastIndexOf(' ') + 1);
+
+    // Flags and source filters ("-h", "-s gambit") are not worth predicting
+    if (lastTerm.startsWith('-')) {
+        return candidates;
+    }
+
+    const QString nextChars = m_catalog->likelyNextChars(lastTerm, MAX_PREFETCH_CHARS);
+    for (const QChar &ch : nextChars) {
+        candidates.append(queryLower + ch);
+    }
+    if (!queryLower.isEmpty()) {
+        candidates.append(queryLower.chopped(1));
+    }
+    return candidates;
+}
+
+void WeaponSearchModel::schedulePrefetch()
+{
+    if (m_catalog->size() == 0) {
+        return;
+    }
+
+    QStringList candidates;
+    for (const QString &candidate : predictNextQueries(m_searchQuery)) {
+        if (!m_resultCache.contains(cacheKey(candidate, m_showLatestSeason))) {
+            candidates.append(candidate);
+        }
+    }
+    if (candidates.isEmpty()) {
+        return;
+    }
+
+    const int generation = m_prefetchGeneration.loadAcquire();
+    const WeaponCatalogPtr catalog = m_catalog;
+    const bool showLatestSeason = m_showLatestSeason;
+    const bool highlightMatches = m_highlightMatches;
+
+    m_prefetchPool.start([this, generation, catalog, showLatestSeason, highlightMatches, candidates]() {
+        for (const QString &candidate : candidates) {
+            // Stop as soon as real input arrives
+            if (m_prefetchGeneration.loadAcquire() != generation) {
+                return;
+            }
+
+            SearchResult result = computeResults(*catalog, candidate, showLatestSeason, highlightMatches);
+
+            // Hand the result to the GUI thread; drop it if the catalog or settings changed meanwhile
+            QMetaObject::invokeMethod(this, [this, catalog, candidate, showLatestSeason, highlightMatches, result]() {
+                if (catalog == m_catalog && highlightMatches == m_highlightMatches) {
+                    m_resultCache.insert(cacheKey(candidate, showLatestSeason), new SearchResult(result));
+                }
+            }, Qt::QueuedConnection);
+        }
+    });
 }
 
 // Normalize text by replacing hyphens with spaces for better matching
@@ -686,6 +1059,96 @@ QString WeaponSearchModel::normalizeText(const QString &text) const
     return result.simplified().toLower();
 }
 
+// Same as normalizeText, but character by character so every output character
+// remembers which position of text it came from (used to map highlight ranges back)
+QString WeaponSearchModel::normalizeTextWithOffsets(const QString &text, QVector<int> &offsets) const
+{
+    QString result;
+    offsets.clear();
+    bool pendingSpace = false;
+    int pendingSpaceOffset = 0;
+
+    for (int i = 0; i < text.length(); ++i) {
+        const int sourceIndex = i;
+        QString piece = text.mid(i, text[i].isHighSurrogate() && i + 1 < text.length() ? 2 : 1);
+        i += piece.length() - 1;
+
+        if (piece == "-" || piece == "_" || piece == "'" || piece == "\"") {
+            piece = " ";
+        }
+
+        for (const QChar &ch : piece.normalized(QString::NormalizationForm_D)) {
+            if (ch.category() == QChar::Mark_NonSpacing) {
+                continue;
+            }
+            // Collapse whitespace runs into one space and drop leading/trailing ones (like simplified())
+            if (ch.isSpace()) {
+                if (!result.isEmpty() && !pendingSpace) {
+                    pendingSpace = true;
+                    pendingSpaceOffset = sourceIndex;
+                }
+                continue;
+            }
+            if (pendingSpace) {
+                result.append(' ');
+                offsets.append(pendingSpaceOffset);
+                pendingSpace = false;
+            }
+            const QString lower = (ch == QChar(0x0131) ? QString(QLatin1Char('i')) : QString(ch).toLower());
+            for (const QChar &lowerCh : lower) {
+                result.append(lowerCh);
+                offsets.append(sourceIndex);
+            }
+        }
+    }
+    return result;
+}
+
+// Convert (start, length) ranges on normalizedText into ranges on the original text
+void WeaponSearchModel::mapMatchSpans(const QString &text, const QString &normalizedText,
+                                      const QVector<int> &ranges, QVector<int> &spans) const
+{
+    QVector<int> offsets;
+    if (normalizeTextWithOffsets(text, offsets) != normalizedText) {
+        return; // Exotic Unicode we can't map exactly: skip highlighting rather than mark wrong characters
+    }
+
+    for (int i = 0; i + 1 < ranges.size(); i += 2) {
+        const int first = offsets[ranges[i]];
+        const int last = offsets[ranges[i] + ranges[i + 1] - 1];
+        const int end = last + (text[last].isHighSurrogate() ? 2 : 1);
+        spans << first << (end - first);
+    }
+}
+
+// Sort (offset, length) pairs and merge overlapping or touching ranges from different terms
+void WeaponSearchModel::mergeMatchSpans(QVector<int> &spans)
+{
+    if (spans.size() <= 2) {
+        return;
+    }
+
+    QList<QPair<int, int>> ranges;
+    for (int i = 0; i + 1 < spans.size(); i += 2) {
+        ranges.append({spans[i], spans[i] + spans[i + 1]});
+    }
+    std::sort(ranges.begin(), ranges.end());
+
+    spans.clear();
+    int start = ranges.first().first;
+    int end = ranges.first().second;
+    for (int i = 1; i < ranges.size(); ++i) {
+        if (ranges[i].first <= end) {
+            end = qMax(end, ranges[i].second);
+        } else {
+            spans << start << (end - start);
+            start = ranges[i].first;
+            end = ranges[i].second;
+        }
+    }
+    spans << start << (end - start);
+}
+
 // Levenshtein distance calculation for typo tolerance (Fuse.js style)
 int WeaponSearchModel::levenshteinDistance(const QString &s1, const QString &s2) const
 {
@@ -725,40 +1188,59 @@ int WeaponSearchModel::levenshteinDistance(const QString &s1, const QString &s2)
 
 // Fuse.js-style fuzzy matching with configurable threshold
 // Returns a score between 0.0 (no match) and 1.0 (perfect match)
-double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pattern) const
+// If spans is given, it receives the matched character ranges of text as (offset, length) pairs
+double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pattern, QVector<int> *spans) const
 {
+    if (spans) spans->clear();
     if (pattern.isEmpty()) return 1.0;
     if (text.isEmpty()) return 0.0;
     
     QString normalizedText = normalizeText(text);
     QString normalizedPattern = normalizeText(pattern);
     
+    // Matched ranges are recorded on the normalized text (only when asked for)
+    // and mapped back to the original text once a branch matches
+    QVector<int> ranges;
+    auto addRange = [&](int start, int length) {
+        if (spans) ranges << start << length;
+    };
+    auto matched = [&](double score) {
+        if (spans && !ranges.isEmpty()) mapMatchSpans(text, normalizedText, ranges, *spans);
+        return score;
+    };
+    
     // Perfect match
     if (normalizedText == normalizedPattern) {
-        return 1.0;
+        addRange(0, normalizedText.length());
+        return matched(1.0);
     }
     
     // Check if text STARTS with pattern - highest priority after perfect match
     if (normalizedText.startsWith(normalizedPattern)) {
         // Longer pattern relative to text = higher score
         double lengthRatio = static_cast<double>(normalizedPattern.length()) / normalizedText.length();
-        return 0.96 + (lengthRatio * 0.03);  // Range: 0.96 - 0.99
+        addRange(0, normalizedPattern.length());
+        return matched(0.96 + (lengthRatio * 0.03));  // Range: 0.96 - 0.99
     }
     
     // Check if any WORD starts with pattern
+    // normalizedText is simplified, so words are separated by exactly one space
     QStringList words = normalizedText.split(' ', Qt::SkipEmptyParts);
+    int wordStart = 0;
     for (int i = 0; i < words.size(); ++i) {
         if (words[i].startsWith(normalizedPattern)) {
+            addRange(wordStart, normalizedPattern.length());
             if (i == 0) {
                 // First word starts with pattern - high priority but below full name match
                 double lengthRatio = static_cast<double>(normalizedPattern.length()) / words[i].length();
-                return 0.92 + (lengthRatio * 0.03);  // Range: 0.92 - 0.95
+                return matched(0.92 + (lengthRatio * 0.03));  // Range: 0.92 - 0.95
             } else {
                 // Later word starts with pattern - much lower priority
                 double wordPositionPenalty = static_cast<double>(i) / words.size() * 0.05;
-                return 0.65 - wordPositionPenalty;  // Range: 0.60 - 0.65
+                return matched(0.65 - wordPositionPenalty);  // Range: 0.60 - 0.65
             }
         }
+        wordStart += words[i].length() + 1;
     }
     
     // Contains match - lower priority than starts-with
@@ -768,10 +1250,12 @@ double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pat
         double positionBonus = 1.0 - (static_cast<double>(containsIndex) / normalizedText.length() * 0.1);
         // Longer pattern relative to text = higher score
         double lengthRatio = static_cast<double>(normalizedPattern.length()) / normalizedText.length();
-        return 0.50 + (positionBonus * 0.08) + (lengthRatio * 0.04);  // Range: 0.50 - 0.62
+        addRange(containsIndex, normalizedPattern.length());
+        return matched(0.50 + (positionBonus * 0.08) + (lengthRatio * 0.04));  // Range: 0.50 - 0.62
     }
     
     // Prefix match on any word with typo tolerance
+    wordStart = 0;
     for (const QString &word : words) {
         if (normalizedPattern.length() <= word.length()) {
             QString wordPrefix = word.left(normalizedPattern.length());
@@ -779,15 +1263,18 @@ double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pat
             int maxDist = qMax(1, normalizedPattern.length() / 3); // Allow ~33% errors
             if (dist <= maxDist) {
                 double score = 0.7 * (1.0 - static_cast<double>(dist) / normalizedPattern.length());
-                return score;
+                addRange(wordStart, normalizedPattern.length());
+                return matched(score);
             }
         }
+        wordStart += word.length() + 1;
     }
     
     // Levenshtein distance on full text for typo tolerance
     // Only consider if pattern is reasonably sized
     if (normalizedPattern.length() >= 3) {
         // Check each word for close matches
+        wordStart = 0;
         for (const QString &word : words) {
             if (qAbs(word.length() - normalizedPattern.length()) <= 2) {
                 int dist = levenshteinDistance(word, normalizedPattern);
@@ -796,9 +1283,11 @@ double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pat
                 if (dist <= maxAllowedDist) {
                     // Score based on how close the match is
                     double score = 0.6 * (1.0 - static_cast<double>(dist) / qMax(word.length(), normalizedPattern.length()));
-                    return score;
+                    addRange(wordStart, word.length());
+                    return matched(score);
                 }
             }
+            wordStart += word.length() + 1;
         }
     }
     
@@ -812,6 +1301,14 @@ double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pat
         if (normalizedText[textIdx] == normalizedPattern[patternIdx]) {
             // Bonus for consecutive matches
             subsequenceScore += 1.0 + consecutiveBonus * 0.5;
+            if (spans) {
+                // Extend the previous range for consecutive characters
+                if (consecutiveBonus > 0 && !ranges.isEmpty()) {
+                    ranges.last()++;
+                } else {
+                    addRange(textIdx, 1);
+                }
+            }
             consecutiveBonus++;
             patternIdx++;
         } else {
@@ -827,20 +1324,21 @@ double WeaponSearchModel::fuseFuzzyMatch(const QString &text, const QString &pat
         double normalizedScore = subsequenceScore / maxPossibleScore;
         // Penalty for long gaps (text much longer than pattern)
         double gapPenalty = 1.0 - (static_cast<double>(normalizedText.length() - normalizedPattern.length()) / normalizedText.length() * 0.3);
-        return qMax(0.0, qMin(0.5, normalizedScore * gapPenalty * 0.5));
+        return matched(qMax(0.0, qMin(0.5, normalizedScore * gapPenalty * 0.5)));
     }
     
     return 0.0; // No match
 }
 
 // Legacy wrapper - converts Fuse.js style score (0-1) to old integer format for compatibility
-int WeaponSearchModel::fuzzyScore(const QString &text, const QString &query) const
+int WeaponSearchModel::fuzzyScore(const QString &text, const QString &query, QVector<int> *spans) const
 {
-    double fuseScore = fuseFuzzyMatch(text, query);
+    double fuseScore = fuseFuzzyMatch(text, query, spans);
     
     // Threshold: require at least 0.3 (30%) match
     const double threshold = 0.3;
     if (fuseScore < threshold) {
+        if (spans) spans->clear();
         return 0;
     }
     
@@ -850,11 +1348,10 @@ int WeaponSearchModel::fuzzyScore(const QString &text, const QString &query) con
 
 void WeaponSearchModel::openWeapon(int index)
 {
-    if (index < 0 || index >= m_filteredWeapons.size())
+    if (index < 0 || index >= m_results.size())
         return;
 
-    QJsonObject weapon = m_filteredWeapons[index].toObject();
-    QString hash = weapon["hash"].toVariant().toString();
+    QString hash = m_catalog->weapon(m_results[index].index).hash;
     
     QString url = QString("https://godroll.tv/%1").arg(hash);
     
@@ -897,6 +1394,70 @@ void WeaponSearchModel::clearSearch()
     setSearchQuery("");
 }
 
+void WeaponSearchModel::prefetchRows(int first, int count)
+{
+    const QStringList paths = iconPaths(first, count);
+    if (!paths.isEmpty()) {
+        emit iconsWanted(paths);
+    }
+}
+
+QStringList WeaponSearchModel::weaponIconPaths() const
+{
+    QStringList paths;
+    if (!m_catalog) {
+        return paths;
+    }
+    QSet<QString> seen;
+    for (const WeaponRecord &weapon : m_catalog->weapons()) {
+        if (!weapon.icon.isEmpty() && !seen.contains(weapon.icon)) {
+            seen.insert(weapon.icon);
+            paths.append(weapon.icon);
+        }
+    }
+    return paths;
+}
+
+QStringList WeaponSearchModel::sharedIconPaths() const
+{
+    QStringList paths;
+    if (!m_catalog) {
+        return paths;
+    }
+    for (const WeaponRecord &weapon : m_catalog->weapons()) {
+        for (const QString &icon : {weapon.damageTypeIcon, weapon.ammoTypeIcon}) {
+            if (!icon.isEmpty() && !paths.contains(icon)) {
+                paths.append(icon);
+            }
+        }
+    }
+    return paths;
+}
+
+// Weapon icons of the rows in order, followed by the (few, shared) damage and ammo icons
+QStringList WeaponSearchModel::iconPaths(int first, int count) const
+{
+    QStringList paths;
+    if (!m_catalog) {
+        return paths;
+    }
+    
+    QStringList shared;
+    const int last = qMin(first + count, int(m_results.size()));
+    for (int row = qMax(0, first); row < last; ++row) {
+        const WeaponRecord &weapon = m_catalog->weapon(m_results[row].index);
+        if (!weapon.icon.isEmpty()) {
+            paths.append(weapon.icon);
+        }
+        for (const QString &icon : {weapon.damageTypeIcon, weapon.ammoTypeIcon}) {
+            if (!icon.isEmpty() && !shared.contains(icon)) {
+                shared.append(icon);
+            }
+        }
+    }
+    return paths + shared;
+}
+
 void WeaponSearchModel::setShowLatestSeason(bool show)
 {
     if (m_showLatestSeason == show)
@@ -907,6 +1468,20 @@ void WeaponSearchModel::setShowLatestSeason(bool show)
     emit showLatestSeasonChanged();
 }
 
+void WeaponSearchModel::setHighlightMatches(bool highlight)
+{
+    if (m_highlightMatches == highlight)
+        return;
+
+    m_highlightMatches = highlight;
+
+    // Cached results were computed with the old setting
+    m_prefetchGeneration.ref();
+    m_resultCache.clear();
+    filterWeapons();
+    emit highlightMatchesChanged();
+}
+
 void WeaponSearchModel::setAutoShowLatestSeason(bool autoShow)
 {
     if (m_autoShowLatestSeason == autoShow)
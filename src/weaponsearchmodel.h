@@ -7,6 +7,13 @@
 #include <QJsonObject>
 #include <QString>
 #include <QStringList>
+#include <QVariantMap>
+#include <QVector>
+#include <QCache>
+#include <QThreadPool>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include "weaponcatalog.h"
 
 class WeaponSearchModel : public QAbstractListModel
 {
@@ -16,6 +23,7 @@ class WeaponSearchModel : public QAbstractListModel
     Q_PROPERTY(bool autoShowLatestSeason READ autoShowLatestSeason WRITE setAutoShowLatestSeason NOTIFY autoShowLatestSeasonChanged)
     Q_PROPERTY(bool openInPWA READ openInPWA WRITE setOpenInPWA NOTIFY openInPWAChanged)
     Q_PROPERTY(QStringList activeSourceFilters READ activeSourceFilters NOTIFY activeSourceFiltersChanged)
+    Q_PROPERTY(bool highlightMatches READ highlightMatches WRITE setHighlightMatches NOTIFY highlightMatchesChanged)
 
 public:
     enum WeaponRoles {
@@ -32,10 +40,13 @@ public:
         DamageTypeRole,
         DamageTypeIconRole,
         AmmoTypeRole,
-        AmmoTypeIconRole
+        AmmoTypeIconRole,
+        MatchSpansRole,    // Matched name ranges as flat (offset, length) pairs, empty when highlighting is off
+        HighlightedNameRole  // Name as StyledText with matched ranges colored, empty when nothing is highlighted
     };
 
     explicit WeaponSearchModel(QObject *parent = nullptr);
+    ~WeaponSearchModel() override;
 
     int rowCount(const QModelIndex &parent = QModelIndex()) const override;
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
@@ -55,40 +66,152 @@ public:
 
     QStringList activeSourceFilters() const { return m_activeSourceFilters; }
 
+    bool highlightMatches() const { return m_highlightMatches; }
+    void setHighlightMatches(bool highlight);
+
     void setWeapons(const QJsonArray &weapons);
+    void setCatalog(const WeaponCatalogPtr &catalog);  // Already indexed (e.g. restored from a snapshot)
 
     Q_INVOKABLE void openWeapon(int index);
     Q_INVOKABLE void clearSearch();
 
+    // Hint the icons of rows just beyond the viewport (called by the list while scrolling)
+    Q_INVOKABLE void prefetchRows(int first, int count);
+
+    // Distinct weapon icons, and damage and ammo type icons (a handful shared by every row)
+    QStringList weaponIconPaths() const;
+    QStringList sharedIconPaths() const;
+
+    // Rank many queries against the current catalog snapshot without touching the model.
+    // Returns one list of weapon hashes per query, ranked exactly like the search results.
+    // Blocks the calling thread until every query is ranked: a batch and benchmark API, not for QML.
+    QVariantList evaluateQueries(const QStringList &queries) const;
+
+    // Approximate bytes per subsystem (catalog, index, resultCache, defaultViews, results)
+    Q_INVOKABLE QVariantMap memoryStats() const;
+    Q_INVOKABLE void logMemoryStats() const;
+
+    // Result order (score desc, season desc, name asc) as one ascending key; nameRank is
+    // WeaponCatalog::nameRank(), score must not be negative
+    static quint64 rankingKey(int score, int seasonNum, int nameRank);
+
+    // Escaped name with each (offset, length) span wrapped in the accent color (StyledText)
+    static QString highlightedName(const QString &name, const QVector<int> &spans);
+
 signals:
     void searchQueryChanged();
     void showLatestSeasonChanged();
     void autoShowLatestSeasonChanged();
     void openInPWAChanged();
     void activeSourceFiltersChanged();
+    void highlightMatchesChanged();
     void weaponsLoaded();
+    void iconsWanted(const QStringList &paths);  // Icon paths the view is about to show, most urgent first
 
 private:
+    friend class TestSearchRanking;
+
+    struct SearchHit {
+        int index;             // Position in the catalog
+        QString matchedField;  // Comma-separated non-name fields that matched
+        QVector<int> matchSpans;  // Matched name ranges as (offset, length) pairs
+    };
+
+    struct SearchResult {
+        QVector<SearchHit> hits;
+        QStringList activeSourceFilters;
+    };
+
+    enum MatchField : quint8 {
+        NoField,
+        NameField,
+        WeaponTypeField,
+        FrameTypeField,
+        SeasonNumberField,
+        SeasonNameField
+    };
+
+    // Best score of one term against one weapon (kept small: batch mode stores one per term and weapon)
+    struct TermMatch {
+        qint16 score = 0;
+        MatchField field = NoField;
+    };
+
+    // Parsed form of a query: flags, source filters and remaining search terms
+    struct QueryPlan {
+        QString queryLower;        // Query with flags, keywords and source filters removed
+        QStringList searchTerms;
+        QStringList sourceFilters;
+        QStringList matchedSourceDisplayNames;
+        bool uniqueByName = false;
+        bool noLimit = false;
+        bool holofoilOnly = false;
+        bool adeptOnly = false;
+        bool exoticOnly = false;
+        bool isSeasonSearch = false;
+        int searchedSeasonNum = -1;
+        QVector<const QVector<TermMatch> *> termScores;  // Optional precomputed column per search term
+    };
+
+    // Precomputed results for empty queries (with any combination of -h/-a/-e/-!/-* flags)
+    enum DefaultViewFlag {
+        HolofoilFlag = 1,
+        AdeptFlag = 2,
+        ExoticFlag = 4,
+        UniqueFlag = 8,
+        NoLimitFlag = 16,
+        DefaultViewCount = 32
+    };
+
     void filterWeapons();
+    QStringList iconPaths(int first, int count) const;
+    void buildDefaultViews();
+    void onDefaultViewsBuilt();
+    static QueryPlan defaultViewPlan(int mask);
+    void patchResultCache();
+    static qint64 hitsBytes(const QVector<SearchHit> &hits, QSet<const void *> &seen);
+    static int defaultViewMask(const QueryPlan &plan);
+    QVector<SearchHit> defaultView(int mask) const;
+    SearchResult computeResults(const WeaponCatalog &catalog, const QString &query, bool showLatestSeason, bool highlightMatches) const;
+    static QString cacheKey(const QString &query, bool showLatestSeason);
+    QueryPlan parseQuery(const WeaponCatalog &catalog, const QString &query) const;
+    SearchResult evaluatePlan(const WeaponCatalog &catalog, const QueryPlan &plan, bool showLatestSeason, bool highlightMatches) const;
+    bool matchesSourceFilter(const QueryPlan &plan, const WeaponRecord &weapon) const;
+    TermMatch scoreTerm(const WeaponCatalog::SearchFields &fields, const QString &term, QVector<int> *nameSpans) const;
+    static QString matchFieldName(MatchField field);
+
+    // Idle-time speculative prefetch of likely next queries into the result cache
+    void schedulePrefetch();
+    QStringList predictNextQueries(const QString &query) const;
     
     // Fuse.js-style fuzzy matching functions
-    int fuzzyScore(const QString &text, const QString &query) const;
-    double fuseFuzzyMatch(const QString &text, const QString &pattern) const;
+    int fuzzyScore(const QString &text, const QString &query, QVector<int> *spans = nullptr) const;
+    double fuseFuzzyMatch(const QString &text, const QString &pattern, QVector<int> *spans = nullptr) const;
     int levenshteinDistance(const QString &s1, const QString &s2) const;
     QString normalizeText(const QString &text) const;
-    
-    // Weapon name helpers
-    QString getBaseWeaponName(const QString &name) const;  // Removes (Adept), (Harrowed), etc.
-    bool isAdeptWeapon(const QJsonObject &weapon) const;   // Checks if weapon is adept (API field or name suffix)
-
-    QJsonArray m_allWeapons;
-    QJsonArray m_filteredWeapons;
+    QString normalizeTextWithOffsets(const QString &text, QVector<int> &offsets) const;
+    void mapMatchSpans(const QString &text, const QString &normalizedText, const QVector<int> &ranges, QVector<int> &spans) const;
+    static void mergeMatchSpans(QVector<int> &spans);
+
+    WeaponCatalogPtr m_catalog;
+    QVector<SearchHit> m_results;
+    QVector<QVector<SearchHit>> m_defaultViews;  // Indexed by DefaultViewFlag mask, empty until built for m_catalog
+    QThreadPool m_defaultViewsPool;              // Own pool so the destructor can wait for superseded builds
+    QFutureWatcher<QVector<SearchHit>> m_defaultViewsWatcher;
+    WeaponCatalogPtr m_defaultViewsCatalog;      // Catalog the running build evaluates
+    QCache<QString, SearchResult> m_resultCache;
+    QThreadPool m_prefetchPool;
+    QAtomicInt m_prefetchGeneration;  // Bumped on real input to stop a running prefetch
     QString m_searchQuery;
-    int m_latestSeason = 0;
     bool m_showLatestSeason = false;
     bool m_autoShowLatestSeason = true;
     bool m_openInPWA = true;      // Open links in Chrome PWA mode (default: true)
+    bool m_highlightMatches = true;  // Record matched name ranges for highlighting
     QStringList m_activeSourceFilters;  // Currently active source filter display names
+
+    static const int MAX_CACHED_RESULTS = 256;
+    static const int MAX_PREFETCH_CHARS = 6;  // Most likely next characters to prefetch
+    static const int PREFETCH_ICON_ROWS = 12;  // Top results whose icons are hinted with each new list
 };
 
 #endif // WEAPONSEARCHMODEL_H
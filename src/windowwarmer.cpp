@@ -0,0 +1,72 @@
+#include "windowwarmer.h"
+#include <QQuickWindow>
+#include <QGuiApplication>
+#include <QSettings>
+#include <QDebug>
+
+WindowWarmer::WindowWarmer(QObject *parent)
+    : QObject(parent)
+{
+    QSettings settings("Godroll.tv", "GodrollLauncher");
+    m_enabled = settings.value("prewarmWindow", hidesTransparentWindows()).toBool();
+    if (!m_enabled) {
+        qDebug() << "Window pre-warm disabled on platform" << QGuiApplication::platformName();
+    }
+}
+
+// Warming maps the real launcher window at zero opacity. Only Windows (DWM) and macOS always
+// composite, so only there is that window truly invisible and click-through. X11 without a
+// compositor or Wayland may ignore the opacity and flash a clickable window instead.
+bool WindowWarmer::hidesTransparentWindows()
+{
+    const QString platform = QGuiApplication::platformName();
+    return platform == QLatin1String("windows") || platform == QLatin1String("cocoa");
+}
+
+void WindowWarmer::attach(QQuickWindow *window)
+{
+    m_window = window;
+    
+    // Keep the graphics context and scene graph while hidden, so a warmed window stays warm
+    window->setPersistentGraphics(true);
+    window->setPersistentSceneGraph(true);
+}
+
+void WindowWarmer::warm()
+{
+    if (!m_enabled || !m_window || m_warming || m_window->isVisible()) {
+        return;
+    }
+    
+    m_warming = true;
+    emit warmingChanged();
+    
+    m_timer.start();
+    
+    // Fully transparent and not activated: nothing flashes and focus stays where it is
+    m_savedOpacity = m_window->opacity();
+    m_window->setOpacity(0.0);
+    m_window->setProperty("_q_showWithoutActivating", true);
+    
+    m_frameConnection = connect(m_window, &QQuickWindow::frameSwapped, this, [this]() {
+        qDebug() << "Window pre-warmed in" << m_timer.elapsed() << "ms";
+        finish();
+    }, Qt::QueuedConnection);
+    m_window->show();
+}
+
+void WindowWarmer::finish()
+{
+    if (!m_warming) {
+        return;
+    }
+    disconnect(m_frameConnection);
+    
+    if (m_window) {
+        m_window->hide();
+        m_window->setProperty("_q_showWithoutActivating", QVariant());
+        m_window->setOpacity(m_savedOpacity);
+    }
+    m_warming = false;
+    emit warmingChanged();
+}
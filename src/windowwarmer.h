@@ -0,0 +1,46 @@
+#ifndef WINDOWWARMER_H
+#define WINDOWWARMER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QMetaObject>
+#include <QElapsedTimer>
+
+class QQuickWindow;
+
+// Renders the hidden launcher window once (transparent, without taking focus) so its scene graph,
+// layout and result delegates already exist when the hotkey shows it. Graphics resources are kept
+// across hide/show. On by default only where a zero-opacity window is guaranteed invisible
+// (Windows, macOS); the prewarmWindow setting overrides that.
+class WindowWarmer : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool warming READ warming NOTIFY warmingChanged)
+
+public:
+    explicit WindowWarmer(QObject *parent = nullptr);
+
+    void attach(QQuickWindow *window);
+    bool warming() const { return m_warming; }
+
+    // Show-render-hide cycle, skipped while the window is visible or warming is disabled
+    Q_INVOKABLE void warm();
+
+    // End a warm-up early (the hotkey arrived mid-cycle), hiding the window again
+    Q_INVOKABLE void finish();
+
+signals:
+    void warmingChanged();
+
+private:
+    static bool hidesTransparentWindows();
+
+    QPointer<QQuickWindow> m_window;
+    QMetaObject::Connection m_frameConnection;
+    QElapsedTimer m_timer;
+    qreal m_savedOpacity = 1.0;
+    bool m_enabled = true;
+    bool m_warming = false;
+};
+
+#endif // WINDOWWARMER_H
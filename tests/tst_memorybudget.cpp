@@ -0,0 +1,158 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "weaponcatalog.h"
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_HEAP_USAGE 1
+
+// Bytes in live heap allocations, including large blocks served by mmap
+static qint64 heapInUse()
+{
+    const struct mallinfo2 info = mallinfo2();
+    return qint64(info.uordblks) + qint64(info.hblkhd);
+}
+#endif
+
+// Catalog memory per weapon at and well beyond today's catalog size (about 10k weapons)
+class TestMemoryBudget : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void catalogStaysWithinBudget_data();
+    void catalogStaysWithinBudget();
+    void catalogSmallerThanJson();
+
+private:
+    QHash<int, qint64> m_bytesPerWeapon;  // By weapon count, for the scaling check
+};
+
+// Records plus search index; the launcher holds one catalog (two while a refresh is diffed)
+static const qint64 MAX_BYTES_PER_WEAPON = 2048;
+
+// Shaped like the API list: unique hash and icon per weapon, names repeating past ~10k, a few dozen distinct
+// types, frames, seasons, sources and damage/ammo icons shared by everything else
+QJsonArray syntheticWeapons(int count)
+{
+    static const QStringList first = {"Fallen", "Bright", "Hollow", "Iron", "Silent", "Vigilant", "Crimson", "Last",
+                                      "Eternal", "Ashen", "Gilded", "Sunken", "Broken", "Distant", "Wicked", "Frozen",
+                                      "Golden", "Hidden", "Savage", "Radiant", "Quiet", "Wandering", "Burning", "Pale",
+                                      "Shattered", "Endless", "Vengeful", "Lucky", "Hungry", "Loyal"};
+    static const QStringList second = {"Guillotine", "Oath", "Horizon", "Gambit", "Verdict", "Harbinger", "Thorn",
+                                       "Warden", "Tempest", "Anthem", "Requiem", "Sentinel", "Lament", "Herald",
+                                       "Compass", "Crown", "Serpent", "Lantern", "Prophet", "Wolf", "Chorus", "Bastion",
+                                       "Cipher", "Rapture", "Mirage", "Ember", "Talon", "Vigil", "Zenith", "Beacon"};
+    static const QStringList third = {"", " Mk. II", " (Adept)", " (Timelost)", " (Harrowed)", " Prime", " IV",
+                                      " XL", " Reborn", " Redux", " Omega", " Alpha"};
+    static const QStringList types = {"Auto Rifle", "Hand Cannon", "Pulse Rifle", "Scout Rifle", "Sidearm",
+                                      "Submachine Gun", "Bow", "Shotgun", "Sniper Rifle", "Fusion Rifle",
+                                      "Trace Rifle", "Grenade Launcher", "Rocket Launcher", "Sword", "Glaive",
+                                      "Machine Gun", "Linear Fusion Rifle"};
+    static const QStringList frames = {"Adaptive Frame", "Aggressive Frame", "Precision Frame", "Rapid-Fire Frame",
+                                       "Lightweight Frame", "High-Impact Frame", "Wave Frame", "Heavy Burst"};
+    static const QStringList damage = {"Kinetic", "Arc", "Solar", "Void", "Stasis", "Strand"};
+    static const QStringList ammo = {"Primary", "Special", "Heavy"};
+    static const QStringList sources = {"Vault of Glass", "Gambit", "Crucible", "Trials of Osiris", "Iron Banner",
+                                        "Nightfall", "World Drop", "Dungeon", "Exotic Mission", "Vanguard Ops"};
+
+    QJsonArray weapons;
+    for (int i = 0; i < count; ++i) {
+        const int season = 1 + i % 28;
+        QJsonObject weapon;
+        weapon["hash"] = 1000000000.0 + i * 7919.0;
+        weapon["name"] = first[i % first.size()] + ' ' + second[(i / first.size()) % second.size()]
+                       + third[(i / (first.size() * second.size())) % third.size()];
+        weapon["icon"] = QString("/common/destiny2_content/icons/%1.jpg")
+                             .arg(QString::number(quint64(i) * 2654435761u, 16).rightJustified(32, '0'));
+        weapon["weaponType"] = types[i % types.size()];
+        weapon["frameType"] = frames[i % frames.size()];
+        weapon["damageType"] = damage[i % damage.size()];
+        weapon["damageTypeIcon"] = "/common/destiny2_content/icons/DestinyDamageTypeDefinition_" + damage[i % damage.size()] + ".png";
+        weapon["ammoType"] = ammo[i % ammo.size()];
+        weapon["ammoTypeIcon"] = "/img/destiny_content/ammo_types/" + ammo[i % ammo.size()].toLower() + ".png";
+        weapon["seasonNumber"] = season;
+        weapon["seasonName"] = QString("Season of Synthetic %1").arg(season);
+        weapon["season"] = QString("Season %1").arg(season);
+        weapon["seasonDisplay"] = QString("Expansion %1 • Season of Synthetic %2").arg(season / 4).arg(season);
+        weapon["sourceDisplayName"] = sources[i % sources.size()];
+        weapon["sourceSearchAliases"] = QJsonArray{sources[i % sources.size()].toLower(), "drop"};
+        weapon["isHolofoil"] = i % 11 == 0;
+        weapon["isExotic"] = i % 23 == 0;
+        // Returned by the endpoint but never read by the launcher
+        weapon["tierTypeName"] = i % 23 == 0 ? "Exotic" : "Legendary";
+        weapon["traitIds"] = QJsonArray{"barrels.rifled", "magazines.tactical", "frames.adaptive", "origins.synthetic"};
+        weapons.append(weapon);
+    }
+    return weapons;
+}
+
+void TestMemoryBudget::catalogStaysWithinBudget_data()
+{
+    QTest::addColumn<int>("count");
+    QTest::newRow("10k") << 10000;
+    QTest::newRow("100k") << 100000;
+}
+
+void TestMemoryBudget::catalogStaysWithinBudget()
+{
+    QFETCH(int, count);
+    const QJsonArray weapons = syntheticWeapons(count);
+
+#ifdef HAVE_HEAP_USAGE
+    const qint64 heapBefore = heapInUse();
+#endif
+    const WeaponCatalogPtr catalog = WeaponCatalog::build(weapons);
+    QCOMPARE(catalog->size(), count);
+    const WeaponCatalog::MemoryUsage usage = catalog->memoryUsage();
+    const qint64 estimated = (usage.records + usage.index) / count;
+
+#ifdef HAVE_HEAP_USAGE
+    const qint64 measured = (heapInUse() - heapBefore) / count;
+    qInfo("%d weapons: records %lld + index %lld bytes/weapon estimated, %lld bytes/weapon measured on the heap",
+          count, usage.records / count, usage.index / count, measured);
+    QVERIFY2(measured <= MAX_BYTES_PER_WEAPON, qPrintable(QString("%1 bytes/weapon on the heap").arg(measured)));
+#else
+    qInfo("%d weapons: records %lld + index %lld bytes/weapon estimated", count, usage.records / count, usage.index / count);
+#endif
+    QVERIFY2(estimated <= MAX_BYTES_PER_WEAPON, qPrintable(QString("%1 bytes/weapon estimated").arg(estimated)));
+
+    // Interned strings and fixed-size tables: the cost per weapon must not grow with the catalog
+    m_bytesPerWeapon.insert(count, estimated);
+    if (m_bytesPerWeapon.contains(10000) && count > 10000) {
+        QVERIFY2(estimated <= m_bytesPerWeapon.value(10000) * 5 / 4,
+                 qPrintable(QString("%1 vs %2 bytes/weapon at 10k").arg(estimated).arg(m_bytesPerWeapon.value(10000))));
+    }
+}
+
+// Before/after for projecting the API list into typed records: the launcher used to keep
+// the parsed QJsonArray resident, it now keeps only the catalog built from it
+void TestMemoryBudget::catalogSmallerThanJson()
+{
+#ifndef HAVE_HEAP_USAGE
+    QSKIP("Heap measurement needs glibc 2.33 or newer");
+#else
+    const int count = 10000;
+    const QByteArray body = QJsonDocument(syntheticWeapons(count)).toJson(QJsonDocument::Compact);
+
+    const qint64 heapStart = heapInUse();
+    QJsonArray weapons = QJsonDocument::fromJson(body).array();
+    const qint64 jsonBytes = heapInUse() - heapStart;
+    QCOMPARE(weapons.size(), count);
+
+    const qint64 heapBeforeCatalog = heapInUse();
+    const WeaponCatalogPtr catalog = WeaponCatalog::build(weapons);
+    const qint64 catalogBytes = heapInUse() - heapBeforeCatalog;
+    weapons = QJsonArray();
+
+    qInfo("%d weapons: parsed JSON %lld bytes/weapon, catalog %lld bytes/weapon (%.1fx smaller)",
+          count, jsonBytes / count, catalogBytes / count, double(jsonBytes) / qMax<qint64>(catalogBytes, 1));
+    QVERIFY2(catalogBytes * 2 <= jsonBytes,
+             qPrintable(QString("catalog %1 vs JSON %2 bytes").arg(catalogBytes).arg(jsonBytes)));
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestMemoryBudget)
+#include "tst_memorybudget.moc"
@@ -0,0 +1,398 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QSemaphore>
+#include <algorithm>
+#include "weaponsearchmodel.h"
+#include "weaponcatalog.h"
+
+// rankingKey() and the catalog's name ranks must order results exactly like the comparator
+// the search used before collation keys (score desc, season desc, lowercased name asc).
+// Also covers match highlighting: spans found on normalized text must land on the original name,
+// and the speculative prefetch: predicted results must equal a live search and stop when superseded.
+// Batch evaluation and the prebuilt default views must rank exactly like typing the query does.
+class TestSearchRanking : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rankingKeyMatchesBaselineComparator();
+    void equalNamesShareRank();
+    void seasonsOutsideKeyRangeAreClamped();
+    void matchSpansMapToName_data();
+    void matchSpansMapToName();
+    void matchSpansMerge_data();
+    void matchSpansMerge();
+    void highlightedNameEscapes();
+    void spansEmptyWhenHighlightingOff();
+    void prefetchMatchesLiveEvaluation();
+    void stalePrefetchStops();
+    void evaluateQueriesMatchesSearch();
+    void defaultViewsMatchEvaluation();
+    void defaultViewsEvaluateLiveUntilBuilt();
+
+private:
+    struct Scored {
+        int score;
+        int season;
+        int weapon;
+    };
+};
+
+static WeaponCatalogPtr catalogWithNames(const QStringList &names)
+{
+    QJsonArray weapons;
+    for (int i = 0; i < names.size(); ++i) {
+        QJsonObject weapon;
+        weapon["hash"] = QString::number(1000 + i);
+        weapon["name"] = names[i];
+        weapons.append(weapon);
+    }
+    return WeaponCatalog::build(weapons);
+}
+
+// A small catalog with seasons, flags and sources, so every kind of query has something to find
+static WeaponCatalogPtr sampleCatalog()
+{
+    struct Sample {
+        const char *name;
+        const char *weaponType;
+        int seasonNumber;
+        bool isHolofoil;
+        bool isExotic;
+        bool isAdept;
+        const char *source;
+        const char *alias;
+    };
+    static const Sample samples[] = {
+        {"Fatebringer", "Hand Cannon", 23, false, false, false, "Vault of Glass", "vog"},
+        {"Fatebringer (Timelost)", "Hand Cannon", 23, true, false, true, "Vault of Glass", "vog"},
+        {"Fate Cries Foul", "Auto Rifle", 25, false, false, false, "Trials of Osiris", "trials"},
+        {"Falling Guillotine", "Sword", 24, false, false, false, "Vow of the Disciple", "vow"},
+        {"Fang of Ir Yut", "Scout Rifle", 20, false, false, false, "Crota's End", "crota"},
+        {"Ace of Spades", "Hand Cannon", 1, false, true, false, "", ""},
+        {"Ace of Spades", "Hand Cannon", 25, true, true, false, "", ""},
+        {"Gjallarhorn", "Rocket Launcher", 16, false, true, false, "Grasp of Avarice", "grasp"},
+        {"Lightweight Knife", "Sidearm", 25, false, false, false, "Gambit", "gambit"},
+        {"Lightweight Knife (Adept)", "Sidearm", 25, false, false, true, "Gambit", "gambit"},
+        {"Trust", "Hand Cannon", 25, false, false, false, "Crucible", "crucible"},
+        {"The Immortal", "Submachine Gun", 25, false, false, false, "Trials of Osiris", "trials"},
+        {"The Immortal (Adept)", "Submachine Gun", 25, true, false, true, "Trials of Osiris", "trials"},
+        {"Vex Mythoclast", "Fusion Rifle", 23, false, true, false, "Vault of Glass", "vog"},
+    };
+
+    QJsonArray weapons;
+    int hash = 1000;
+    for (const Sample &sample : samples) {
+        QJsonObject weapon;
+        weapon["hash"] = QString::number(hash++);
+        weapon["name"] = sample.name;
+        weapon["weaponType"] = sample.weaponType;
+        weapon["seasonNumber"] = sample.seasonNumber;
+        weapon["isHolofoil"] = sample.isHolofoil;
+        weapon["isExotic"] = sample.isExotic;
+        weapon["isAdept"] = sample.isAdept;
+        weapon["sourceDisplayName"] = sample.source;
+        if (*sample.alias) {
+            weapon["sourceSearchAliases"] = QJsonArray{sample.alias};
+        }
+        weapons.append(weapon);
+    }
+    return WeaponCatalog::build(weapons);
+}
+
+template <typename Hits>
+static QVector<int> hitIndexes(const Hits &hits)
+{
+    QVector<int> indexes;
+    indexes.reserve(hits.size());
+    for (const auto &hit : hits) {
+        indexes.append(hit.index);
+    }
+    return indexes;
+}
+
+void TestSearchRanking::rankingKeyMatchesBaselineComparator()
+{
+    const QStringList names = {
+        "Fatebringer", "Fatebringer (Timelost)", "fatebringer", "Ace of Spades", "ace of spades",
+        "1000 Yard Stare", "Zhalo Supercell", "Éclipse", "eclipse", "Vex Mythoclast", "VEX MYTHOCLAST",
+        "The Immortal", "Immortal", "Nullify (Adept)", "Nullify", "Gjallarhorn", "Ikelos_SMG_v1.0.3"
+    };
+    const WeaponCatalogPtr catalog = catalogWithNames(names);
+
+    // Realistic scores with plenty of ties, so season and name decide often
+    const QVector<int> scores = {0, 80, 120, 120, 500, 1000, 1450, 2000};
+    QRandomGenerator random(20240611);
+    QVector<Scored> entries;
+    for (int i = 0; i < 400; ++i) {
+        entries.append({scores[random.bounded(int(scores.size()))], random.bounded(31),
+                        random.bounded(catalog->size())});
+    }
+
+    auto baselineLess = [&catalog](const Scored &a, const Scored &b) {
+        if (a.score != b.score) {
+            return a.score > b.score;
+        }
+        if (a.season != b.season) {
+            return a.season > b.season;
+        }
+        return catalog->weapon(a.weapon).name.toLower() < catalog->weapon(b.weapon).name.toLower();
+    };
+    auto key = [&catalog](const Scored &entry) {
+        return WeaponSearchModel::rankingKey(entry.score, entry.season, catalog->nameRank(entry.weapon));
+    };
+
+    for (const Scored &a : entries) {
+        for (const Scored &b : entries) {
+            const bool less = baselineLess(a, b);
+            QCOMPARE(key(a) < key(b), less);
+            QCOMPARE(key(a) == key(b), !less && !baselineLess(b, a));
+        }
+    }
+
+    // Same check through a full sort
+    QVector<Scored> byBaseline = entries;
+    QVector<Scored> byKey = entries;
+    std::stable_sort(byBaseline.begin(), byBaseline.end(), baselineLess);
+    std::stable_sort(byKey.begin(), byKey.end(), [&key](const Scored &a, const Scored &b) { return key(a) < key(b); });
+    for (int i = 0; i < entries.size(); ++i) {
+        QCOMPARE(byKey[i].score, byBaseline[i].score);
+        QCOMPARE(byKey[i].season, byBaseline[i].season);
+        QCOMPARE(byKey[i].weapon, byBaseline[i].weapon);
+    }
+}
+
+void TestSearchRanking::equalNamesShareRank()
+{
+    const WeaponCatalogPtr catalog = catalogWithNames({"Ace of Spades", "ACE OF SPADES", "Bad Juju", "ace of spades"});
+    QCOMPARE(catalog->nameRank(0), catalog->nameRank(1));
+    QCOMPARE(catalog->nameRank(0), catalog->nameRank(3));
+    QVERIFY(catalog->nameRank(0) < catalog->nameRank(2));
+}
+
+void TestSearchRanking::seasonsOutsideKeyRangeAreClamped()
+{
+    // Score still dominates, and out-of-range seasons don't spill into the score bits
+    QVERIFY(WeaponSearchModel::rankingKey(501, 0, 0) < WeaponSearchModel::rankingKey(500, 99999, 0));
+    QVERIFY(WeaponSearchModel::rankingKey(500, -3, 0) > WeaponSearchModel::rankingKey(500, 1, 0));
+    QCOMPARE(WeaponSearchModel::rankingKey(500, 0x1000, 7), WeaponSearchModel::rankingKey(500, 0xfff, 7));
+}
+
+void TestSearchRanking::matchSpansMapToName_data()
+{
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QVector<int>>("spans");  // (offset, length) pairs on name
+
+    QTest::newRow("prefix, precomposed accent") << QString("\u00c9clipse") << "ecl" << QVector<int>{0, 3};
+    QTest::newRow("prefix, combining accent") << QString("E\u0301clipse") << "ecl" << QVector<int>{0, 4};
+    QTest::newRow("accent inside match") << QString("D\u00ebad Man's Tale") << "dead" << QVector<int>{0, 4};
+    QTest::newRow("later word after underscore") << "Ikelos_SMG_v1.0.3" << "smg" << QVector<int>{7, 3};
+    QTest::newRow("collapsed whitespace") << "  The   Immortal" << "immortal" << QVector<int>{8, 8};
+    QTest::newRow("contains after surrogate pair") << QString::fromUtf8("\xf0\x9f\x94\xa5Fire") << "fire"
+                                                   << QVector<int>{2, 4};
+    QTest::newRow("typo window on word prefix") << "Fatebringer" << "fatr" << QVector<int>{0, 4};
+    QTest::newRow("typo window, second word") << QString("Le M\u00f5narque") << "monarqeu" << QVector<int>{3, 8};
+    QTest::newRow("typo on whole word") << "Nullify (Adept)" << "nulliffy" << QVector<int>{0, 7};
+    QTest::newRow("subsequence") << "Ace of Spades" << "aspd" << QVector<int>{0, 1, 7, 2, 10, 1};
+    QTest::newRow("subsequence, accented") << QString("\u00c9clipse") << "eis" << QVector<int>{0, 1, 3, 1, 5, 1};
+    QTest::newRow("no match") << "Gjallarhorn" << "xyz" << QVector<int>();
+}
+
+void TestSearchRanking::matchSpansMapToName()
+{
+    QFETCH(QString, name);
+    QFETCH(QString, pattern);
+    QFETCH(QVector<int>, spans);
+
+    WeaponSearchModel model;
+    QVector<int> actual;
+    const double score = model.fuseFuzzyMatch(name, pattern, &actual);
+    QCOMPARE(actual, spans);
+    QCOMPARE(score > 0.0, !spans.isEmpty());
+
+    // Every span stays inside the name and never splits a surrogate pair
+    for (int i = 0; i + 1 < actual.size(); i += 2) {
+        QVERIFY(actual[i] >= 0 && actual[i + 1] > 0 && actual[i] + actual[i + 1] <= name.size());
+        QVERIFY(!name[actual[i]].isLowSurrogate());
+    }
+}
+
+void TestSearchRanking::matchSpansMerge_data()
+{
+    QTest::addColumn<QVector<int>>("spans");
+    QTest::addColumn<QVector<int>>("merged");
+
+    QTest::newRow("single") << QVector<int>{4, 2} << QVector<int>{4, 2};
+    QTest::newRow("unsorted") << QVector<int>{5, 2, 0, 3} << QVector<int>{0, 3, 5, 2};
+    QTest::newRow("overlapping") << QVector<int>{0, 4, 2, 4} << QVector<int>{0, 6};
+    QTest::newRow("touching") << QVector<int>{0, 3, 3, 2} << QVector<int>{0, 5};
+    QTest::newRow("contained") << QVector<int>{0, 10, 2, 3, 12, 1} << QVector<int>{0, 10, 12, 1};
+}
+
+void TestSearchRanking::matchSpansMerge()
+{
+    QFETCH(QVector<int>, spans);
+    QFETCH(QVector<int>, merged);
+
+    WeaponSearchModel::mergeMatchSpans(spans);
+    QCOMPARE(spans, merged);
+}
+
+void TestSearchRanking::highlightedNameEscapes()
+{
+    QCOMPARE(WeaponSearchModel::highlightedName("A<b> & C", {0, 1, 7, 1}),
+             QString("<font color=\"#09d7d0\">A</font>&lt;b&gt; &amp; <font color=\"#09d7d0\">C</font>"));
+    QCOMPARE(WeaponSearchModel::highlightedName("Fatebringer", {}), QString("Fatebringer"));
+}
+
+void TestSearchRanking::spansEmptyWhenHighlightingOff()
+{
+    WeaponSearchModel model;
+    model.setCatalog(catalogWithNames({"Fatebringer", "Fatebringer (Timelost)", "Ace of Spades"}));
+    model.setSearchQuery("fate");
+    QCOMPARE(model.rowCount(), 2);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row);
+        QCOMPARE(index.data(WeaponSearchModel::MatchSpansRole).value<QVector<int>>(), (QVector<int>{0, 4}));
+        QVERIFY(!index.data(WeaponSearchModel::HighlightedNameRole).toString().isEmpty());
+    }
+
+    model.setHighlightMatches(false);
+    QCOMPARE(model.rowCount(), 2);
+    for (int row = 0; row < model.rowCount(); ++row) {
+        const QModelIndex index = model.index(row);
+        QVERIFY(index.data(WeaponSearchModel::MatchSpansRole).value<QVector<int>>().isEmpty());
+        QVERIFY(index.data(WeaponSearchModel::HighlightedNameRole).toString().isEmpty());
+    }
+}
+
+void TestSearchRanking::prefetchMatchesLiveEvaluation()
+{
+    WeaponSearchModel model;
+    model.setCatalog(sampleCatalog());
+    model.setSearchQuery("fa");
+
+    const QStringList candidates = model.predictNextQueries("fa");
+    QVERIFY(candidates.contains("fat"));
+    QVERIFY(candidates.contains("fal"));
+    QVERIFY(candidates.contains("f"));
+
+    // Predicted results arrive through queued calls once the pool has run them
+    model.m_prefetchPool.waitForDone();
+    for (const QString &candidate : candidates) {
+        const QString key = WeaponSearchModel::cacheKey(candidate, model.m_showLatestSeason);
+        QTRY_VERIFY(model.m_resultCache.contains(key));
+
+        const WeaponSearchModel::SearchResult *cached = model.m_resultCache.object(key);
+        const WeaponSearchModel::SearchResult live = model.computeResults(*model.m_catalog, candidate,
+                                                                          model.m_showLatestSeason,
+                                                                          model.m_highlightMatches);
+        QCOMPARE(cached->hits.size(), live.hits.size());
+        for (int i = 0; i < live.hits.size(); ++i) {
+            QCOMPARE(cached->hits[i].index, live.hits[i].index);
+            QCOMPARE(cached->hits[i].matchedField, live.hits[i].matchedField);
+            QCOMPARE(cached->hits[i].matchSpans, live.hits[i].matchSpans);
+        }
+        QCOMPARE(cached->activeSourceFilters, live.activeSourceFilters);
+    }
+}
+
+void TestSearchRanking::stalePrefetchStops()
+{
+    WeaponSearchModel model;
+    model.setCatalog(sampleCatalog());
+    model.setSearchQuery("fa");
+    model.m_prefetchPool.waitForDone();
+    QCoreApplication::processEvents();
+    model.m_resultCache.clear();
+
+    // Hold the pool so the prefetch is still queued when real input arrives
+    QSemaphore release;
+    model.m_prefetchPool.setMaxThreadCount(1);
+    model.m_prefetchPool.start([&release]() { release.acquire(); });
+    model.schedulePrefetch();
+    model.m_prefetchGeneration.ref();
+    release.release();
+
+    model.m_prefetchPool.waitForDone();
+    QCoreApplication::processEvents();
+    const QStringList candidates = model.predictNextQueries("fa");
+    QVERIFY(!candidates.isEmpty());
+    for (const QString &candidate : candidates) {
+        QVERIFY(!model.m_resultCache.contains(WeaponSearchModel::cacheKey(candidate, model.m_showLatestSeason)));
+    }
+}
+
+void TestSearchRanking::evaluateQueriesMatchesSearch()
+{
+    const QStringList queries = {
+        "fate", "hand cannon", "immortal adept", "fatr", "25", "s23",
+        "-h", "-e", "-a", "-!", "-*", "-h!*", "fate -a", "ace -!", "-e -*",
+        "-s gambit", "-s trials immortal", "-s vog -h", "-s trials -s crucible"
+    };
+
+    WeaponSearchModel model;
+    model.setCatalog(sampleCatalog());
+    QTRY_VERIFY(!model.m_defaultViews.isEmpty());
+
+    const QVariantList batch = model.evaluateQueries(queries);
+    QCOMPARE(batch.size(), queries.size());
+    QVERIFY(!batch.first().toList().isEmpty());
+    for (int i = 0; i < queries.size(); ++i) {
+        model.setSearchQuery(queries[i]);
+        QVariantList typed;
+        for (int row = 0; row < model.rowCount(); ++row) {
+            typed.append(model.index(row).data(WeaponSearchModel::HashRole));
+        }
+        QVERIFY2(batch[i].toList() == typed, qPrintable(queries[i]));
+    }
+}
+
+void TestSearchRanking::defaultViewsMatchEvaluation()
+{
+    WeaponSearchModel model;
+    model.setCatalog(sampleCatalog());
+    QTRY_VERIFY(!model.m_defaultViews.isEmpty());
+    QVERIFY(model.m_showLatestSeason);
+
+    for (int mask = 0; mask < WeaponSearchModel::DefaultViewCount; ++mask) {
+        const WeaponSearchModel::QueryPlan plan = WeaponSearchModel::defaultViewPlan(mask);
+        QCOMPARE(WeaponSearchModel::defaultViewMask(plan), mask);
+        QCOMPARE(hitIndexes(model.defaultView(mask)),
+                 hitIndexes(model.evaluatePlan(*model.m_catalog, plan, model.m_showLatestSeason, false).hits));
+    }
+}
+
+void TestSearchRanking::defaultViewsEvaluateLiveUntilBuilt()
+{
+    WeaponSearchModel model;
+    const WeaponCatalogPtr catalog = sampleCatalog();
+
+    // Hold the pool so the build cannot land before the lookups below
+    QSemaphore release;
+    model.m_defaultViewsPool.setMaxThreadCount(1);
+    model.m_defaultViewsPool.start([&release]() { release.acquire(); });
+    model.setCatalog(catalog);
+    QVERIFY(model.m_defaultViews.isEmpty());
+
+    QVector<QVector<int>> live(WeaponSearchModel::DefaultViewCount);
+    for (int mask = 0; mask < WeaponSearchModel::DefaultViewCount; ++mask) {
+        live[mask] = hitIndexes(model.defaultView(mask));
+        QCOMPARE(live[mask], hitIndexes(model.evaluatePlan(*catalog, WeaponSearchModel::defaultViewPlan(mask),
+                                                           model.m_showLatestSeason, false).hits));
+    }
+    QCOMPARE(model.rowCount(), live[0].size());
+
+    // Once the build lands it serves the same lists
+    release.release();
+    QTRY_VERIFY(!model.m_defaultViews.isEmpty());
+    for (int mask = 0; mask < WeaponSearchModel::DefaultViewCount; ++mask) {
+        QCOMPARE(hitIndexes(model.defaultView(mask)), live[mask]);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSearchRanking)
+#include "tst_searchranking.moc"
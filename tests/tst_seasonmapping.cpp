@@ -0,0 +1,175 @@
+#include <QtTest>
+#include <QJsonArray>
+#include <iterator>
+#include "seasonmapping.h"
+
+// The compiled table (generated from resources/seasons.csv) must resolve every release exactly
+// like the hand-written table it replaced
+class TestSeasonMapping : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void resolvesBaselineTable_data();
+    void resolvesBaselineTable();
+    void compiledTableMatchesBaseline();
+    void traitParsing_data();
+    void traitParsing();
+    void csvSplitting_data();
+    void csvSplitting();
+};
+
+struct BaselineSeason {
+    int version;
+    const char *name;
+    int number;
+    const char *expansion;
+    const char *type;
+};
+
+// Copied from the initSeasons() table that seasons.csv replaced
+static const BaselineSeason BASELINE[] = {
+    {300, "", 1, "Red War", "annual"},
+    {310, "", 2, "Curse of Osiris", "annual"},
+    {320, "", 3, "Warmind", "annual"},
+    {400, "", 4, "Forsaken", "annual"},
+    {410, "Season of the Forge", 5, "", "season"},
+    {420, "Season of the Drifter", 6, "", "season"},
+    {450, "Season of Opulence", 7, "", "season"},
+    {460, "Season of the Undying", 8, "Shadowkeep", "season"},
+    {470, "Season of Dawn", 9, "", "season"},
+    {480, "Season of the Worthy", 10, "", "season"},
+    {490, "Season of Arrivals", 11, "", "season"},
+    {500, "Season of the Hunt", 12, "Beyond Light", "season"},
+    {510, "Season of the Chosen", 13, "", "season"},
+    {520, "Season of the Splicer", 14, "", "season"},
+    {530, "Season of the Lost", 15, "", "season"},
+    {540, "", 15, "30th Anniversary Pack", "season"},
+    {600, "Season of the Risen", 16, "The Witch Queen", "season"},
+    {610, "Season of the Haunted", 17, "", "season"},
+    {620, "Season of Plunder", 18, "", "season"},
+    {630, "Season of the Seraph", 19, "", "season"},
+    {700, "Season of Defiance", 20, "Lightfall", "season"},
+    {710, "Season of the Deep", 21, "", "season"},
+    {720, "Season of the Witch", 22, "", "season"},
+    {730, "Season of the Wish", 23, "", "season"},
+    {800, "", 24, "The Final Shape", "season"},
+    {810, "Episode: Echoes", 25, "", "season"},
+    {820, "Episode: Revenant", 26, "", "season"},
+    {900, "Reclamation", 27, "Edge of Fate", "core"},
+    {910, "Ash & Iron", 27, "Edge of Fate", "core"},
+    {950, "Renegades", 28, "", "season"},
+};
+static const int BASELINE_COUNT = int(std::size(BASELINE));
+
+void TestSeasonMapping::initTestCase()
+{
+    // Unknown versions must not pick up a seasons.csv from the developer's app data folder
+    qputenv("GODROLL_SEASONS_FILE", QByteArray(QTest::currentAppName()) + "-no-such-file.csv");
+}
+
+void TestSeasonMapping::resolvesBaselineTable_data()
+{
+    QTest::addColumn<int>("version");
+    QTest::addColumn<QString>("name");
+    QTest::addColumn<int>("number");
+    QTest::addColumn<QString>("expansion");
+    QTest::addColumn<QString>("type");
+
+    for (const BaselineSeason &season : BASELINE) {
+        QTest::addRow("v%d", season.version) << season.version << QString::fromUtf8(season.name) << season.number
+                                             << QString::fromUtf8(season.expansion) << QString::fromUtf8(season.type);
+    }
+}
+
+void TestSeasonMapping::resolvesBaselineTable()
+{
+    QFETCH(int, version);
+    QFETCH(QString, name);
+    QFETCH(int, number);
+    QFETCH(QString, expansion);
+    QFETCH(QString, type);
+
+    const QJsonArray traits{"weapon.type.auto_rifle", QString("releases.v%1.%2").arg(version).arg(type)};
+    const SeasonInfo *info = SeasonMapping::instance().resolve(traits);
+    QVERIFY(info);
+    QCOMPARE(info->identifier, QString("v%1").arg(version));
+    QCOMPARE(info->name, name);
+    QCOMPARE(info->number, number);
+    QCOMPARE(info->expansion, expansion);
+    QCOMPARE(info->type, type);
+
+    // Same strings the old getters built on every call
+    SeasonInfo baseline;
+    baseline.name = name;
+    baseline.number = number;
+    baseline.expansion = expansion;
+    QCOMPARE(info->display, baseline.displayName());
+    QCOMPARE(info->shortName, !name.isEmpty() ? name : expansion);
+    QCOMPARE(SeasonMapping::instance().getSeasonFromTraitIds(traits), baseline.displayName());
+    QCOMPARE(SeasonMapping::instance().getSeasonNumber(traits), number);
+}
+
+void TestSeasonMapping::compiledTableMatchesBaseline()
+{
+    QCOMPARE(int(std::size(SEASON_TABLE)), BASELINE_COUNT);
+    for (int i = 0; i < BASELINE_COUNT; ++i) {
+        QCOMPARE(SEASON_TABLE[i].version, BASELINE[i].version);
+        QCOMPARE(SEASON_TABLE[i].number, BASELINE[i].number);
+        QCOMPARE(QString::fromUtf8(SEASON_TABLE[i].name), QString::fromUtf8(BASELINE[i].name));
+        QCOMPARE(QString::fromUtf8(SEASON_TABLE[i].expansion), QString::fromUtf8(BASELINE[i].expansion));
+        QCOMPARE(QString::fromUtf8(SEASON_TABLE[i].type), QString::fromUtf8(BASELINE[i].type));
+    }
+}
+
+void TestSeasonMapping::traitParsing_data()
+{
+    QTest::addColumn<QStringList>("traits");
+    QTest::addColumn<int>("number");  // 0 when nothing resolves
+
+    QTest::newRow("no suffix") << QStringList{"releases.v300"} << 1;
+    QTest::newRow("first known release wins") << QStringList{"releases.v950.season", "releases.v300.annual"} << 28;
+    QTest::newRow("unknown release skipped") << QStringList{"releases.v999.season", "releases.v410.season"} << 5;
+    QTest::newRow("digits only") << QStringList{"releases.v30x.annual"} << 0;
+    QTest::newRow("no digits") << QStringList{"releases.v.season"} << 0;
+    QTest::newRow("other traits") << QStringList{"item_type.weapon", "foundry.hakke"} << 0;
+    QTest::newRow("empty") << QStringList() << 0;
+}
+
+void TestSeasonMapping::traitParsing()
+{
+    QFETCH(QStringList, traits);
+    QFETCH(int, number);
+
+    const QJsonArray traitIds = QJsonArray::fromStringList(traits);
+    const SeasonInfo *info = SeasonMapping::instance().resolve(traitIds);
+    QCOMPARE(info ? info->number : 0, number);
+}
+
+void TestSeasonMapping::csvSplitting_data()
+{
+    QTest::addColumn<QByteArray>("line");
+    QTest::addColumn<QList<QByteArray>>("fields");  // Empty when the row is rejected
+
+    QTest::newRow("plain") << QByteArray("300,1,annual,Red War,")
+                           << QList<QByteArray>{"300", "1", "annual", "Red War", ""};
+    QTest::newRow("quoted comma") << QByteArray("999,40,annual,\"Forsaken, Annual Pass\",Dawn")
+                                  << QList<QByteArray>{"999", "40", "annual", "Forsaken, Annual Pass", "Dawn"};
+    QTest::newRow("escaped quote") << QByteArray("999,40,season,,\"The \"\"Last\"\" Wish\"")
+                                   << QList<QByteArray>{"999", "40", "season", "", "The \"Last\" Wish"};
+    QTest::newRow("empty quoted") << QByteArray("\"\",1") << QList<QByteArray>{"", "1"};
+    QTest::newRow("unterminated quote") << QByteArray("999,40,season,\"Open,Name") << QList<QByteArray>();
+    QTest::newRow("text after quote") << QByteArray("999,40,\"season\"x,,Name") << QList<QByteArray>();
+}
+
+void TestSeasonMapping::csvSplitting()
+{
+    QFETCH(QByteArray, line);
+    QFETCH(QList<QByteArray>, fields);
+
+    QCOMPARE(SeasonMapping::splitCsvLine(line), fields);
+}
+
+QTEST_GUILESS_MAIN(TestSeasonMapping)
+#include "tst_seasonmapping.moc"
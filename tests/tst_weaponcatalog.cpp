@@ -0,0 +1,221 @@
+#include <QtTest>
+#include <QBuffer>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "weaponcatalog.h"
+
+class TestWeaponCatalog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void snapshotRoundTrip();
+    void truncatedSnapshotIsRejected();
+    void corruptCountDoesNotAllocate();
+    void updateMatchesBuild();
+    void updateReportsDelta();
+    void chainedUpdatesMatchBuild();
+    void updateWithoutBaseBuilds();
+};
+
+static QJsonObject weapon(const QString &hash, const QString &name, const QString &type, int season,
+                          bool holofoil = false, bool exotic = false)
+{
+    QJsonObject object;
+    object["hash"] = hash;
+    object["name"] = name;
+    object["icon"] = "/common/destiny2_content/icons/" + hash + ".jpg";
+    object["weaponType"] = type;
+    object["frameType"] = type == "Sword" ? "Vortex Frame" : "Adaptive Frame";
+    object["seasonNumber"] = season;
+    object["seasonName"] = QString("Season Name %1").arg(season);
+    object["season"] = QString("Season %1").arg(season);
+    object["seasonDisplay"] = QString("Expansion • Season Name %1").arg(season);
+    object["damageType"] = "Void";
+    object["damageTypeIcon"] = "/icons/void.png";
+    object["ammoType"] = "Primary";
+    object["ammoTypeIcon"] = "/icons/primary.png";
+    object["sourceDisplayName"] = season % 2 ? "Vault of Glass" : "Gambit";
+    object["sourceSearchAliases"] = QJsonArray{season % 2 ? "VoG" : "Gambit", "Raid"};
+    object["isHolofoil"] = holofoil;
+    object["isExotic"] = exotic;
+    return object;
+}
+
+static QJsonArray sampleWeapons()
+{
+    return QJsonArray{
+        weapon("1", "Fatebringer", "Hand Cannon", 23),
+        weapon("2", "Fatebringer (Timelost)", "Hand Cannon", 23, true),
+        weapon("3", "Ace of Spades", "Hand Cannon", 4, false, true),
+        weapon("4", "Nullify", "Pulse Rifle", 27),
+        weapon("5", "Nullify (Adept)", "Pulse Rifle", 27, true),
+        weapon("6", "Falling Guillotine", "Sword", 14),
+        weapon("6", "Falling Guillotine", "Sword", 28),  // Repeated hash, told apart by occurrence
+    };
+}
+
+// Everything a search reads must be identical, derived data included
+static void compareCatalogs(const WeaponCatalog &actual, const WeaponCatalog &expected)
+{
+    QCOMPARE(actual.size(), expected.size());
+    QCOMPARE(actual.latestSeason(), expected.latestSeason());
+    for (int i = 0; i < expected.size(); ++i) {
+        QVERIFY2(actual.weapon(i) == expected.weapon(i), qPrintable(expected.weapon(i).name));
+        const WeaponCatalog::SearchFields &a = actual.searchFields(i);
+        const WeaponCatalog::SearchFields &e = expected.searchFields(i);
+        QCOMPARE(a.name, e.name);
+        QCOMPARE(a.nameLower, e.nameLower);
+        QCOMPARE(a.baseName, e.baseName);
+        QCOMPARE(a.weaponType, e.weaponType);
+        QCOMPARE(a.frameType, e.frameType);
+        QCOMPARE(a.seasonName, e.seasonName);
+        QCOMPARE(a.season, e.season);
+        QCOMPARE(a.seasonDisplay, e.seasonDisplay);
+        QCOMPARE(a.seasonNumber, e.seasonNumber);
+        QCOMPARE(a.seasonNum, e.seasonNum);
+        QCOMPARE(actual.nameRank(i), expected.nameRank(i));
+        QCOMPARE(actual.isHolofoil(i), expected.isHolofoil(i));
+        QCOMPARE(actual.isExotic(i), expected.isExotic(i));
+        QCOMPARE(actual.isAdept(i), expected.isAdept(i));
+    }
+    QCOMPARE(actual.vocabulary().size(), expected.vocabulary().size());
+    for (int i = 0; i < expected.vocabulary().size(); ++i) {
+        QCOMPARE(actual.vocabulary()[i].word, expected.vocabulary()[i].word);
+        QCOMPARE(actual.vocabulary()[i].weight, expected.vocabulary()[i].weight);
+    }
+}
+
+static QByteArray serialize(const WeaponCatalog &catalog)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    catalog.writeTo(out);
+    return bytes;
+}
+
+static WeaponCatalogPtr deserialize(const QByteArray &bytes)
+{
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_6_0);
+    return WeaponCatalog::readFrom(in);
+}
+
+void TestWeaponCatalog::snapshotRoundTrip()
+{
+    const WeaponCatalogPtr catalog = WeaponCatalog::build(sampleWeapons());
+    const WeaponCatalogPtr restored = deserialize(serialize(*catalog));
+    QVERIFY(restored);
+    QVERIFY(restored->serial() != catalog->serial());
+    compareCatalogs(*restored, *catalog);
+
+    // A restored catalog serializes to the same bytes again
+    QCOMPARE(serialize(*restored), serialize(*catalog));
+}
+
+void TestWeaponCatalog::truncatedSnapshotIsRejected()
+{
+    const QByteArray bytes = serialize(*WeaponCatalog::build(sampleWeapons()));
+    for (const qsizetype size : {qsizetype(0), qsizetype(3), qsizetype(40), bytes.size() / 2, bytes.size() - 1}) {
+        QVERIFY2(!deserialize(bytes.left(size)), qPrintable(QString("cut at %1 of %2").arg(size).arg(bytes.size())));
+    }
+}
+
+void TestWeaponCatalog::corruptCountDoesNotAllocate()
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << quint32(0xffffffff);
+    QVERIFY(!deserialize(bytes));
+}
+
+// Rename, remove, add and reorder against sampleWeapons()
+static QJsonArray editedWeapons()
+{
+    QJsonArray weapons = sampleWeapons();
+    QJsonObject ace = weapons[2].toObject();
+    ace["name"] = "Ace of Spades (Forged)";
+    weapons[2] = ace;
+    weapons.removeAt(3);  // Nullify
+    weapons.append(weapon("7", "Gjallarhorn", "Rocket Launcher", 28, false, true));
+    const QJsonValue first = weapons.takeAt(0);
+    weapons.append(first);
+    return weapons;
+}
+
+static int indexOfHash(const WeaponCatalog &catalog, const QString &hash)
+{
+    for (int i = 0; i < catalog.size(); ++i) {
+        if (catalog.weapon(i).hash == hash) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void TestWeaponCatalog::updateMatchesBuild()
+{
+    const WeaponCatalogPtr base = WeaponCatalog::build(sampleWeapons());
+    const QJsonArray weapons = editedWeapons();
+    compareCatalogs(*WeaponCatalog::update(base, weapons), *WeaponCatalog::build(weapons));
+}
+
+void TestWeaponCatalog::updateReportsDelta()
+{
+    const WeaponCatalogPtr base = WeaponCatalog::build(sampleWeapons());
+    const WeaponCatalogPtr updated = WeaponCatalog::update(base, editedWeapons());
+    const WeaponCatalog::Delta &delta = updated->delta();
+
+    QCOMPARE(delta.baseSerial, base->serial());
+    QCOMPARE(delta.added, QVector<int>{indexOfHash(*updated, "7")});
+    QCOMPARE(delta.changed, QVector<int>{indexOfHash(*updated, "3")});
+    QCOMPARE(delta.removed, QVector<int>{indexOfHash(*base, "4")});
+
+    // Unchanged weapons map to their new position, changed and removed ones to -1
+    QCOMPARE(delta.baseToNew.size(), base->size());
+    for (int j = 0; j < base->size(); ++j) {
+        const int i = delta.baseToNew[j];
+        const QString hash = base->weapon(j).hash;
+        if (hash == "3" || hash == "4") {
+            QCOMPARE(i, -1);
+        } else {
+            QVERIFY2(i >= 0, qPrintable(hash));
+            QVERIFY(updated->weapon(i) == base->weapon(j));
+        }
+    }
+
+    // Both copies of the repeated hash survive in order
+    QCOMPARE(updated->weapon(delta.baseToNew[5]).seasonNumber, 14);
+    QCOMPARE(updated->weapon(delta.baseToNew[6]).seasonNumber, 28);
+}
+
+void TestWeaponCatalog::chainedUpdatesMatchBuild()
+{
+    WeaponCatalogPtr catalog = WeaponCatalog::build(sampleWeapons());
+    QJsonArray weapons = sampleWeapons();
+    for (int round = 0; round < 5; ++round) {
+        QJsonObject changed = weapons[round % weapons.size()].toObject();
+        changed["seasonNumber"] = 30 + round;
+        changed["isHolofoil"] = !changed["isHolofoil"].toBool();
+        weapons[round % weapons.size()] = changed;
+        weapons.append(weapon(QString::number(100 + round), QString("Added Weapon %1").arg(round), "Sidearm", round));
+        if (round % 2) {
+            weapons.removeAt(1);
+        }
+
+        catalog = WeaponCatalog::update(catalog, weapons);
+        compareCatalogs(*catalog, *WeaponCatalog::build(weapons));
+    }
+}
+
+void TestWeaponCatalog::updateWithoutBaseBuilds()
+{
+    const WeaponCatalogPtr catalog = WeaponCatalog::update(WeaponCatalogPtr(), sampleWeapons());
+    QCOMPARE(catalog->delta().baseSerial, 0);
+    compareCatalogs(*catalog, *WeaponCatalog::build(sampleWeapons()));
+}
+
+QTEST_GUILESS_MAIN(TestWeaponCatalog)
+#include "tst_weaponcatalog.moc"
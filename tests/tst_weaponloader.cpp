@@ -0,0 +1,389 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QNetworkProxy>
+#include <QPointer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStandardPaths>
+#include "weaponloader.h"
+
+// Local HTTP/1.1 server answering each request with the next scripted response
+// (slow, failing, 304 or changed), recording what the loader sent and when
+class FakeServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Response {
+        int status = 200;
+        QByteArray body;
+        QList<QPair<QByteArray, QByteArray>> headers;
+        int delayMs = 0;
+    };
+
+    struct Request {
+        QHash<QByteArray, QByteArray> headers;  // Lowercased names
+        qint64 receivedAt = 0;                  // Msecs since the server started
+    };
+
+    FakeServer()
+    {
+        connect(&m_server, &QTcpServer::newConnection, this, &FakeServer::onNewConnection);
+        m_server.listen(QHostAddress::LocalHost);
+        m_clock.start();
+    }
+
+    QUrl url() const { return QUrl(QString("http://127.0.0.1:%1/api/weapons/list").arg(m_server.serverPort())); }
+
+    void enqueue(const Response &response) { m_responses.append(response); }
+    void enqueue(int status, const QByteArray &body = QByteArray(), int delayMs = 0,
+                 const QList<QPair<QByteArray, QByteArray>> &headers = {})
+    {
+        enqueue(Response{status, body, headers, delayMs});
+    }
+
+    QList<Request> requests;
+
+private slots:
+    void onNewConnection()
+    {
+        while (QTcpSocket *socket = m_server.nextPendingConnection()) {
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    }
+
+private:
+    void onReadyRead(QTcpSocket *socket)
+    {
+        QByteArray &buffer = m_buffers[socket];
+        buffer += socket->readAll();
+        const int end = buffer.indexOf("\r\n\r\n");
+        if (end < 0) {
+            return;
+        }
+
+        Request request;
+        request.receivedAt = m_clock.elapsed();
+        const QList<QByteArray> lines = buffer.left(end).split('\n');
+        for (int i = 1; i < lines.size(); ++i) {
+            const int colon = lines[i].indexOf(':');
+            if (colon > 0) {
+                request.headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+            }
+        }
+        requests.append(request);
+        m_buffers.remove(socket);
+
+        const Response response = m_responses.isEmpty() ? Response{503, QByteArray(), {}, 0} : m_responses.takeFirst();
+        QPointer<QTcpSocket> guard(socket);
+        QTimer::singleShot(response.delayMs, this, [guard, response]() {
+            if (!guard || guard->state() != QAbstractSocket::ConnectedState) {
+                return;
+            }
+            static const QHash<int, QByteArray> reasons = {
+                {200, "OK"}, {304, "Not Modified"}, {500, "Internal Server Error"}, {503, "Service Unavailable"}
+            };
+            QByteArray head = "HTTP/1.1 " + QByteArray::number(response.status) + ' '
+                            + reasons.value(response.status, "Status") + "\r\n";
+            head += "Content-Type: application/json\r\n";
+            head += "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n";
+            head += "Connection: close\r\n";
+            for (const auto &header : response.headers) {
+                head += header.first + ": " + header.second + "\r\n";
+            }
+            guard->write(head + "\r\n" + response.body);
+            guard->disconnectFromHost();
+        });
+    }
+
+    QTcpServer m_server;
+    QElapsedTimer m_clock;
+    QList<Response> m_responses;
+    QHash<QTcpSocket *, QByteArray> m_buffers;
+};
+
+class TestWeaponLoader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void retryScheduleBacksOff();
+    void loadFailedAfterMaxRetries();
+    void timeoutCountsAsFailure();
+    void notModifiedKeepsCatalog();
+    void identicalBodyShortCircuits();
+    void changedBodyPublishesDelta();
+    void snapshotSearchableBeforeSlowServer();
+    void corruptSnapshotIsIgnored_data();
+    void corruptSnapshotIsIgnored();
+
+private:
+    static QByteArray weaponsBody(int count);
+    static QString snapshotPath();
+    void loadOnce(FakeServer &server, const QByteArray &body, const QList<QPair<QByteArray, QByteArray>> &headers = {});
+};
+
+static const auto NO_CALLBACK = [](const WeaponCatalogPtr &) {};
+
+QByteArray TestWeaponLoader::weaponsBody(int count)
+{
+    static const char *const names[] = {"Fatebringer", "Ace of Spades", "Nullify", "Gjallarhorn", "Vex Mythoclast"};
+    QJsonArray weapons;
+    for (int i = 0; i < count; ++i) {
+        QJsonObject weapon;
+        weapon["hash"] = 1000 + i;
+        weapon["name"] = QString("%1 %2").arg(names[i % 5]).arg(i);
+        weapon["weaponType"] = "Hand Cannon";
+        weapon["traitIds"] = QJsonArray{"releases.v720.season"};
+        weapons.append(weapon);
+    }
+    QJsonObject body;
+    body["success"] = true;
+    body["weapons"] = weapons;
+    return QJsonDocument(body).toJson(QJsonDocument::Compact);
+}
+
+QString TestWeaponLoader::snapshotPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/catalog.bin";
+}
+
+void TestWeaponLoader::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QNetworkProxy::setApplicationProxy(QNetworkProxy::NoProxy);
+    qRegisterMetaType<WeaponCatalogPtr>();
+}
+
+void TestWeaponLoader::init()
+{
+    QFile::remove(snapshotPath());
+}
+
+// One successful load, leaving a snapshot with the given validators behind
+void TestWeaponLoader::loadOnce(FakeServer &server, const QByteArray &body, const QList<QPair<QByteArray, QByteArray>> &headers)
+{
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    server.enqueue(200, body, 0, headers);
+    loader.loadWeapons(NO_CALLBACK);
+    QTRY_COMPARE(loaded.count(), 1);
+    QVERIFY(QFile::exists(snapshotPath()));
+}
+
+void TestWeaponLoader::retryScheduleBacksOff()
+{
+    FakeServer server;
+    server.enqueue(500);
+    server.enqueue(500);
+    server.enqueue(200, weaponsBody(3));
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    loader.setRetryBaseDelay(200);
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    loader.loadWeapons(NO_CALLBACK);
+    QTRY_COMPARE_WITH_TIMEOUT(loaded.count(), 1, 5000);
+    QCOMPARE(server.requests.size(), 3);
+
+    // Equal jitter: attempt n waits between half and all of base * 2^(n-1).
+    // Timers may fire slightly early, the upper bound leaves room for the round trip.
+    const qint64 firstGap = server.requests[1].receivedAt - server.requests[0].receivedAt;
+    const qint64 secondGap = server.requests[2].receivedAt - server.requests[1].receivedAt;
+    QVERIFY2(firstGap >= 90 && firstGap <= 200 + 300, qPrintable(QString::number(firstGap)));
+    QVERIFY2(secondGap >= 180 && secondGap <= 400 + 300, qPrintable(QString::number(secondGap)));
+
+    QVERIFY(!loader.stale());
+    QCOMPARE(loaded.at(0).at(0).value<WeaponCatalogPtr>()->size(), 3);
+}
+
+void TestWeaponLoader::loadFailedAfterMaxRetries()
+{
+    FakeServer server;
+    for (int i = 0; i < 3; ++i) {
+        server.enqueue(500);
+    }
+    server.enqueue(200, weaponsBody(2));
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    loader.setRetryBaseDelay(20);
+    QSignalSpy failed(&loader, &WeaponLoader::loadFailed);
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    loader.loadWeapons(NO_CALLBACK);
+
+    // Reported once after the third failure, retrying goes on and the fourth attempt succeeds
+    QTRY_COMPARE(failed.count(), 1);
+    QVERIFY(loader.stale());
+    QTRY_COMPARE(loaded.count(), 1);
+    QCOMPARE(failed.count(), 1);
+    QCOMPARE(server.requests.size(), 4);
+    QVERIFY(!loader.stale());
+    QVERIFY(loader.lastError().isEmpty());
+}
+
+void TestWeaponLoader::timeoutCountsAsFailure()
+{
+    FakeServer server;
+    server.enqueue(200, weaponsBody(2), 2000);
+    server.enqueue(200, weaponsBody(4));
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    loader.setRequestTimeout(300);
+    loader.setRetryBaseDelay(20);
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    loader.loadWeapons(NO_CALLBACK);
+
+    QTRY_COMPARE_WITH_TIMEOUT(loaded.count(), 1, 3000);
+    QCOMPARE(server.requests.size(), 2);
+    QCOMPARE(loaded.at(0).at(0).value<WeaponCatalogPtr>()->size(), 4);
+}
+
+void TestWeaponLoader::notModifiedKeepsCatalog()
+{
+    FakeServer server;
+    server.enqueue(200, weaponsBody(3), 0, {{"ETag", "\"v1\""}, {"Last-Modified", "Tue, 11 Jun 2024 10:00:00 GMT"}});
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    QSignalSpy unchanged(&loader, &WeaponLoader::weaponsUnchanged);
+    loader.loadWeapons(NO_CALLBACK);
+    QTRY_COMPARE(loaded.count(), 1);
+    QVERIFY(!server.requests[0].headers.contains("if-none-match"));
+
+    server.enqueue(304);
+    loader.reload();
+    QTRY_COMPARE(unchanged.count(), 1);
+    QCOMPARE(loaded.count(), 1);
+    QCOMPARE(server.requests[1].headers.value("if-none-match"), QByteArray("\"v1\""));
+    QCOMPARE(server.requests[1].headers.value("if-modified-since"), QByteArray("Tue, 11 Jun 2024 10:00:00 GMT"));
+    QVERIFY(!loader.stale());
+}
+
+void TestWeaponLoader::identicalBodyShortCircuits()
+{
+    // No validators: the server sends the full body again, the payload hash catches it
+    FakeServer server;
+    server.enqueue(200, weaponsBody(3));
+    server.enqueue(200, weaponsBody(3));
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    QSignalSpy unchanged(&loader, &WeaponLoader::weaponsUnchanged);
+    loader.loadWeapons(NO_CALLBACK);
+    QTRY_COMPARE(loaded.count(), 1);
+
+    loader.reload();
+    QTRY_COMPARE(unchanged.count(), 1);
+    QCOMPARE(loaded.count(), 1);
+    QVERIFY(!server.requests[1].headers.contains("if-none-match"));
+}
+
+void TestWeaponLoader::changedBodyPublishesDelta()
+{
+    FakeServer server;
+    server.enqueue(200, weaponsBody(3));
+    server.enqueue(200, weaponsBody(4));
+
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    QSignalSpy unchanged(&loader, &WeaponLoader::weaponsUnchanged);
+    loader.loadWeapons(NO_CALLBACK);
+    QTRY_COMPARE(loaded.count(), 1);
+
+    loader.reload();
+    QTRY_COMPARE(loaded.count(), 2);
+    QCOMPARE(unchanged.count(), 0);
+    const WeaponCatalogPtr first = loaded.at(0).at(0).value<WeaponCatalogPtr>();
+    const WeaponCatalogPtr second = loaded.at(1).at(0).value<WeaponCatalogPtr>();
+    QCOMPARE(second->size(), 4);
+    QCOMPARE(second->delta().baseSerial, first->serial());
+    QCOMPARE(second->delta().added.size(), 1);
+    QVERIFY(second->delta().changed.isEmpty());
+    QVERIFY(second->delta().removed.isEmpty());
+}
+
+void TestWeaponLoader::snapshotSearchableBeforeSlowServer()
+{
+    FakeServer server;
+    loadOnce(server, weaponsBody(5), {{"ETag", "\"v2\""}});
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // Slow server: the snapshot makes the launcher searchable long before it answers
+    server.enqueue(304, QByteArray(), 1500);
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    QSignalSpy unchanged(&loader, &WeaponLoader::weaponsUnchanged);
+    QElapsedTimer timer;
+    timer.start();
+    loader.loadWeapons(NO_CALLBACK);
+    QCOMPARE(loaded.count(), 1);
+    QVERIFY2(timer.elapsed() < 1000, qPrintable(QString("%1 ms").arg(timer.elapsed())));
+    QCOMPARE(loaded.at(0).at(0).value<WeaponCatalogPtr>()->size(), 5);
+
+    // Then revalidates with the validators stored in the snapshot
+    QTRY_COMPARE_WITH_TIMEOUT(unchanged.count(), 1, 5000);
+    QCOMPARE(loaded.count(), 1);
+    QCOMPARE(server.requests.last().headers.value("if-none-match"), QByteArray("\"v2\""));
+}
+
+void TestWeaponLoader::corruptSnapshotIsIgnored_data()
+{
+    QTest::addColumn<QString>("damage");
+    QTest::newRow("flipped payload byte") << "flip";
+    QTest::newRow("truncated") << "truncate";
+    QTest::newRow("bad magic") << "magic";
+}
+
+void TestWeaponLoader::corruptSnapshotIsIgnored()
+{
+    QFETCH(QString, damage);
+
+    FakeServer server;
+    loadOnce(server, weaponsBody(5), {{"ETag", "\"v3\""}});
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    QFile file(snapshotPath());
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QByteArray bytes = file.readAll();
+    if (damage == "flip") {
+        bytes[bytes.size() - 10] = char(bytes[bytes.size() - 10] ^ 0x5a);
+    } else if (damage == "truncate") {
+        bytes.chop(bytes.size() / 3);
+    } else {
+        bytes[0] = 'X';
+    }
+    QVERIFY(file.resize(0));
+    QVERIFY(file.seek(0));
+    QCOMPARE(file.write(bytes), bytes.size());
+    file.close();
+
+    // Nothing is published from the damaged file and no validators are sent
+    server.enqueue(200, weaponsBody(2));
+    WeaponLoader loader;
+    loader.setEndpoint(server.url());
+    QSignalSpy loaded(&loader, &WeaponLoader::catalogLoaded);
+    loader.loadWeapons(NO_CALLBACK);
+    QCOMPARE(loaded.count(), 0);
+    QTRY_COMPARE(loaded.count(), 1);
+    QCOMPARE(loaded.at(0).at(0).value<WeaponCatalogPtr>()->size(), 2);
+    QVERIFY(!server.requests.last().headers.contains("if-none-match"));
+}
+
+QTEST_GUILESS_MAIN(TestWeaponLoader)
+#include "tst_weaponloader.moc"